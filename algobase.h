@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstring>
+#include <type_traits>
 
+#include "deque_iterator.h"
 #include "iterator.h"
+#include "simd.h"
 #include "util.h"
 
 namespace mystl {
@@ -97,5 +100,311 @@ copy(T1 *first, T1 *last, T2 *result) {
 // copy [first, last) to [result - (last - first), result)
 /**************************************************************************** */
 // bidirectional_iterator_tag
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+BidirectionalIterator2 copy_backward(BidirectionalIterator1 first,
+                                     BidirectionalIterator1 last,
+                                     BidirectionalIterator2 result) {
+    while (first != last) {
+        *--result = *--last;
+    }
+    return result;
+}
+
+// copy_backward for trivial type
+template <class T1, class T2>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<T1>::type, T2>::value &&
+        std::is_trivially_copy_assignable<T2>::value,
+    T2 *>::type
+copy_backward(T1 *first, T1 *last, T2 *result) {
+    const auto n = static_cast<size_t>(last - first);
+    if (n != 0) {
+        std::memmove(result - n, first, n * sizeof(T2));
+    }
+    return result - n;
+}
+
+/**************************************************************************** */
+// move
+// move [first, last) to [result, result + (last - first))
+/**************************************************************************** */
+template <class InputIterator, class OutputIterator>
+OutputIterator move(InputIterator first, InputIterator last,
+                    OutputIterator result) {
+    for (; first != last; ++first, ++result) {
+        *result = mystl::move(*first);
+    }
+    return result;
+}
+
+// 平凡类型的移动就是拷贝
+template <class T1, class T2>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<T1>::type, T2>::value &&
+        std::is_trivially_copy_assignable<T2>::value,
+    T2 *>::type
+move(T1 *first, T1 *last, T2 *result) {
+    return mystl::copy(first, last, result);
+}
+
+/**************************************************************************** */
+// move_backward
+// move [first, last) to [result - (last - first), result)
+/**************************************************************************** */
+template <class BidirectionalIterator1, class BidirectionalIterator2>
+BidirectionalIterator2 move_backward(BidirectionalIterator1 first,
+                                     BidirectionalIterator1 last,
+                                     BidirectionalIterator2 result) {
+    while (first != last) {
+        *--result = mystl::move(*--last);
+    }
+    return result;
+}
 
+template <class T1, class T2>
+typename std::enable_if<
+    std::is_same<typename std::remove_const<T1>::type, T2>::value &&
+        std::is_trivially_copy_assignable<T2>::value,
+    T2 *>::type
+move_backward(T1 *first, T1 *last, T2 *result) {
+    return mystl::copy_backward(first, last, result);
+}
+
+/**************************************************************************** */
+// fill
+// fill [first, last) with value
+/**************************************************************************** */
+template <class ForwardIterator, class T>
+void fill(ForwardIterator first, ForwardIterator last, const T &value) {
+    for (; first != last; ++first) {
+        *first = value;
+    }
+}
+
+// 单字节平凡类型用memset
+template <class T>
+typename std::enable_if<sizeof(T) == 1 && std::is_trivially_copy_assignable<
+                                              T>::value>::type
+fill(T *first, T *last, const T &value) {
+    if (first != last) {
+        unsigned char byte;
+        std::memcpy(&byte, &value, 1);
+        std::memset(first, byte, static_cast<size_t>(last - first));
+    }
+}
+
+/**************************************************************************** */
+// find
+// first iterator in [first, last) equal to value, or last
+/**************************************************************************** */
+template <class InputIterator, class T>
+InputIterator find(InputIterator first, InputIterator last, const T &value) {
+    while (first != last && !(*first == value)) {
+        ++first;
+    }
+    return first;
+}
+
+// 连续内存交给simd::find
+template <class T>
+T *find(T *first, T *last, const typename std::remove_const<T>::type &value) {
+    return first + simd::find(first, static_cast<size_t>(last - first), value);
+}
+
+/**************************************************************************** */
+// for_each
+/**************************************************************************** */
+template <class InputIterator, class Function>
+Function for_each(InputIterator first, InputIterator last, Function f) {
+    for (; first != last; ++first) {
+        f(*first);
+    }
+    return f;
+}
+
+/**************************************************************************** */
+// deque_iterator的分段版本
+// deque的区间由若干段连续缓冲区组成，逐段交给上面的指针版本处理，
+// 段内循环不再检查缓冲区边界，可以使用memmove/memset或者向量化
+/**************************************************************************** */
+// 对[first, last)的每段连续内存调用f(段首, 段尾)
+template <class T, size_t BufSize, class Function>
+void for_each_segment(deque_iterator<T, BufSize> first,
+                      deque_iterator<T, BufSize> last, Function f) {
+    if (first.node == last.node) {
+        f(first.cur, last.cur);
+        return;
+    }
+    f(first.cur, first.last);
+    for (T **node = first.node + 1; node < last.node; ++node) {
+        f(*node, *node + deque_iterator<T, BufSize>::buffer_size());
+    }
+    f(last.first, last.cur);
+}
+
+namespace detail {
+// 连续内存 -> deque：按目标缓冲区切段，op(段首, 段尾, 目标)处理一段
+template <class T1, class T2, size_t BufSize, class Op>
+deque_iterator<T2, BufSize> segmented_forward(T1 *first, T1 *last,
+                                              deque_iterator<T2, BufSize> result,
+                                              Op op) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        const ptrdiff_t room = result.last - result.cur;
+        const ptrdiff_t len = n < room ? n : room;
+        op(first, first + len, result.cur);
+        first += len;
+        n -= len;
+        result += len;
+    }
+    return result;
+}
+
+// 从后往前按目标缓冲区切段，op(段首, 段尾, 目标段尾)处理一段
+template <class T1, class T2, size_t BufSize, class Op>
+deque_iterator<T2, BufSize> segmented_backward(
+    T1 *first, T1 *last, deque_iterator<T2, BufSize> result, Op op) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        ptrdiff_t room = result.cur - result.first;
+        T2 *end = result.cur;
+        if (room == 0) {
+            // result位于缓冲区开头，实际写入的是上一个缓冲区的末尾
+            room = deque_iterator<T2, BufSize>::buffer_size();
+            end = *(result.node - 1) + room;
+        }
+        const ptrdiff_t len = n < room ? n : room;
+        op(last - len, last, end);
+        last -= len;
+        n -= len;
+        result -= len;
+    }
+    return result;
+}
+
+// 从后往前遍历deque区间的每段连续内存
+template <class T, size_t BufSize, class Function>
+void for_each_segment_backward(deque_iterator<T, BufSize> first,
+                               deque_iterator<T, BufSize> last, Function f) {
+    ptrdiff_t n = last - first;
+    while (n > 0) {
+        ptrdiff_t room = last.cur - last.first;
+        T *end = last.cur;
+        if (room == 0) {
+            room = deque_iterator<T, BufSize>::buffer_size();
+            end = *(last.node - 1) + room;
+        }
+        const ptrdiff_t len = n < room ? n : room;
+        f(end - len, end);
+        n -= len;
+        last -= len;
+    }
+}
+}  // namespace detail
+
+template <class T1, class T2, size_t BufSize>
+deque_iterator<T2, BufSize> copy(T1 *first, T1 *last,
+                                 deque_iterator<T2, BufSize> result) {
+    return detail::segmented_forward(
+        first, last, result,
+        [](T1 *b, T1 *e, T2 *out) { mystl::copy(b, e, out); });
+}
+
+// deque -> 任意输出：按源缓冲区切段
+template <class T, size_t BufSize, class OutputIterator>
+OutputIterator copy(deque_iterator<T, BufSize> first,
+                    deque_iterator<T, BufSize> last, OutputIterator result) {
+    mystl::for_each_segment(first, last, [&](T *b, T *e) {
+        result = mystl::copy(b, e, result);
+    });
+    return result;
+}
+
+template <class T1, class T2, size_t BufSize>
+deque_iterator<T2, BufSize> copy_backward(T1 *first, T1 *last,
+                                          deque_iterator<T2, BufSize> result) {
+    return detail::segmented_backward(
+        first, last, result,
+        [](T1 *b, T1 *e, T2 *out) { mystl::copy_backward(b, e, out); });
+}
+
+template <class T, size_t BufSize, class BidirectionalIterator>
+BidirectionalIterator copy_backward(deque_iterator<T, BufSize> first,
+                                    deque_iterator<T, BufSize> last,
+                                    BidirectionalIterator result) {
+    detail::for_each_segment_backward(first, last, [&](T *b, T *e) {
+        result = mystl::copy_backward(b, e, result);
+    });
+    return result;
+}
+
+template <class T1, class T2, size_t BufSize>
+deque_iterator<T2, BufSize> move(T1 *first, T1 *last,
+                                 deque_iterator<T2, BufSize> result) {
+    return detail::segmented_forward(
+        first, last, result,
+        [](T1 *b, T1 *e, T2 *out) { mystl::move(b, e, out); });
+}
+
+template <class T, size_t BufSize, class OutputIterator>
+OutputIterator move(deque_iterator<T, BufSize> first,
+                    deque_iterator<T, BufSize> last, OutputIterator result) {
+    mystl::for_each_segment(first, last, [&](T *b, T *e) {
+        result = mystl::move(b, e, result);
+    });
+    return result;
+}
+
+template <class T1, class T2, size_t BufSize>
+deque_iterator<T2, BufSize> move_backward(T1 *first, T1 *last,
+                                          deque_iterator<T2, BufSize> result) {
+    return detail::segmented_backward(
+        first, last, result,
+        [](T1 *b, T1 *e, T2 *out) { mystl::move_backward(b, e, out); });
+}
+
+template <class T, size_t BufSize, class BidirectionalIterator>
+BidirectionalIterator move_backward(deque_iterator<T, BufSize> first,
+                                    deque_iterator<T, BufSize> last,
+                                    BidirectionalIterator result) {
+    detail::for_each_segment_backward(first, last, [&](T *b, T *e) {
+        result = mystl::move_backward(b, e, result);
+    });
+    return result;
+}
+
+template <class T, size_t BufSize, class U>
+void fill(deque_iterator<T, BufSize> first, deque_iterator<T, BufSize> last,
+          const U &value) {
+    mystl::for_each_segment(first, last,
+                            [&](T *b, T *e) { mystl::fill(b, e, value); });
+}
+
+template <class T, size_t BufSize, class U>
+deque_iterator<T, BufSize> find(deque_iterator<T, BufSize> first,
+                                deque_iterator<T, BufSize> last,
+                                const U &value) {
+    while (first.node != last.node) {
+        T *p = mystl::find(first.cur, first.last, value);
+        if (p != first.last) {
+            first.cur = p;
+            return first;
+        }
+        first.set_node(first.node + 1);
+        first.cur = first.first;
+    }
+    first.cur = mystl::find(first.cur, last.cur, value);
+    return first;
+}
+
+template <class T, size_t BufSize, class Function>
+Function for_each(deque_iterator<T, BufSize> first,
+                  deque_iterator<T, BufSize> last, Function f) {
+    mystl::for_each_segment(first, last, [&](T *b, T *e) {
+        for (; b != e; ++b) {
+            f(*b);
+        }
+    });
+    return f;
+}
 }  // namespace mystl
\ No newline at end of file
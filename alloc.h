@@ -123,43 +123,12 @@ class MemoryPool {
         return static_cast<void *>(node);
     }
 
+    // 释放的节点只回到空闲链表，内存块在池的整个生命周期内保留，
+    // 分配和释放都是O(1)，在块边界附近反复申请释放也不会触发malloc/free
     void deallocate(void *p) {
         FreeNode *node = static_cast<FreeNode *>(p);
         node->next = free_list;
         free_list = node;
-
-        for (size_t i = 0; i < all_blocks_count; i++) {
-            if (is_in_block(p, all_blocks[i])) {
-                size_t free_count = 0;
-                for (FreeNode *cur = free_list; cur != nullptr;
-                     cur = cur->next) {
-                    if (is_in_block(cur, all_blocks[i])) {
-                        free_count++;
-                    }
-                }
-                if (free_count == elem_count) {
-                    FreeNode *cur = free_list;
-                    while (is_in_block(cur, all_blocks[i])) {
-                        cur = cur->next;
-                    }
-                    free_list = cur;
-                    FreeNode *next = cur->next;
-                    while (next != nullptr) {
-                        if (is_in_block(next, all_blocks[i])) {
-                            cur->next = next->next;
-                            next = cur->next;
-                        } else {
-                            cur = next;
-                            next = next->next;
-                        }
-                    }
-
-                    ::free(all_blocks[i]);
-                    all_blocks[i] = all_blocks[--all_blocks_count];
-                    break;
-                }
-            }
-        }
     }
 
    private:
@@ -172,6 +141,9 @@ class MemoryPool {
             all_blocks = new_blocks;
         }
         void *block = ::malloc(elem_size * elem_count);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
         all_blocks[all_blocks_count++] = block;
         for (size_t i = 0; i < elem_count; ++i) {
             deallocate(static_cast<char *>(block) + i * elem_size);
@@ -191,7 +163,7 @@ class MemoryPoolManager {
         if (n > MAX_BYTES) {
             return malloc_alloc::allocate(n);
         }
-        size_t index = round_up(n) / ALIGN;
+        size_t index = index_of(n);
         if (pool_map[index] == nullptr) {
             pool_map[index] =
                 new MemoryPool(index * ALIGN, ELEM_COUNT, MAX_BLOCKS_COUNT);
@@ -203,8 +175,7 @@ class MemoryPoolManager {
         if (n > MAX_BYTES) {
             malloc_alloc::deallocate(p, n);
         } else {
-            size_t index = round_up(n) / ALIGN;
-            pool_map[index]->deallocate(p);
+            pool_map[index_of(n)]->deallocate(p);
         }
     }
 
@@ -226,6 +197,10 @@ class MemoryPoolManager {
     static size_t round_up(size_t n) {
         return (n + ALIGN - 1) & ~size_t(ALIGN - 1);
     }
+    // 0字节的请求按最小的一档处理
+    static size_t index_of(size_t n) {
+        return n == 0 ? 1 : round_up(n) / ALIGN;
+    }
 };
 MemoryPool *MemoryPoolManager::pool_map[MAX_BYTES / ALIGN + 1] = {nullptr};
 
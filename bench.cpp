@@ -0,0 +1,210 @@
+// 并发容器和定时器的吞吐量测试，与test.cpp一样单独编译运行：
+//   g++ -std=c++17 -O2 -pthread bench.cpp -o bench && ./bench
+// 结果依赖核数和缓存，线程数取std::thread::hardware_concurrency()
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mystl.h"
+
+using bench_clock = std::chrono::steady_clock;
+
+static double elapsed_ms(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() -
+                                                     start)
+        .count();
+}
+
+static void print_result(const char *name, uint64_t ops, double ms) {
+    std::cout << name << ": " << ms << " ms, " << ops / ms / 1000.0
+              << " M ops/s" << std::endl;
+}
+
+static unsigned bench_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n < 2 ? 2 : n;
+}
+
+// work_stealing_deque：所有者单线程push/pop，以及所有者生产、其余线程窃取；
+// 对照组是互斥量保护的mystl::deque
+static void bench_work_stealing_deque() {
+    const int64_t n = 10000000;
+    {
+        mystl::work_stealing_deque<int64_t> dq;
+        int64_t v, sum = 0;
+        auto start = bench_clock::now();
+        for (int64_t i = 0; i < n; i += 64) {
+            for (int64_t k = 0; k < 64; ++k) dq.push(i + k);
+            while (dq.pop(v)) sum += v;
+        }
+        print_result("work_stealing_deque owner push/pop", 2 * n,
+                     elapsed_ms(start));
+        if (sum != n * (n - 1) / 2) std::cout << "  wrong sum" << std::endl;
+    }
+    {
+        mystl::deque<int64_t> dq;
+        std::mutex m;
+        int64_t sum = 0;
+        auto start = bench_clock::now();
+        for (int64_t i = 0; i < n; i += 64) {
+            for (int64_t k = 0; k < 64; ++k) {
+                std::lock_guard<std::mutex> lock(m);
+                dq.push_back(i + k);
+            }
+            for (;;) {
+                std::lock_guard<std::mutex> lock(m);
+                if (dq.empty()) break;
+                sum += dq.back();
+                dq.pop_back();
+            }
+        }
+        print_result("mutex + deque owner push/pop", 2 * n, elapsed_ms(start));
+        if (sum != n * (n - 1) / 2) std::cout << "  wrong sum" << std::endl;
+    }
+    {
+        const unsigned thieves = bench_threads() - 1;
+        mystl::work_stealing_deque<int64_t> dq;
+        std::atomic<int64_t> consumed(0);
+        std::atomic<bool> done(false);
+        std::vector<std::thread> threads;
+        auto start = bench_clock::now();
+        for (unsigned i = 0; i < thieves; ++i) {
+            threads.emplace_back([&] {
+                int64_t v, local = 0;
+                while (!done.load(std::memory_order_acquire) || !dq.empty()) {
+                    if (dq.steal(v)) {
+                        ++local;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                consumed += local;
+            });
+        }
+        int64_t v, local = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            dq.push(i);
+            // 所有者每压入4个自己取回1个，其余留给窃取者
+            if ((i & 3) == 3 && dq.pop(v)) ++local;
+        }
+        while (dq.pop(v)) ++local;
+        done.store(true, std::memory_order_release);
+        for (auto &t : threads) t.join();
+        consumed += local;
+        print_result("work_stealing_deque owner + thieves", n,
+                     elapsed_ms(start));
+        if (consumed != n) std::cout << "  lost elements" << std::endl;
+    }
+}
+
+// concurrent_skip_list：1个到全部线程同时查找，看读操作是否随线程数扩展；
+// 对照组是互斥量保护的mystl::map
+static void bench_concurrent_skip_list() {
+    const int keys = 1 << 16, lookups = 2000000;
+    mystl::concurrent_skip_list_map<int, int> sl;
+    mystl::map<int, int> m;
+    std::mutex mu;
+    for (int k = 0; k < keys; ++k) {
+        sl.insert(mystl::pair<const int, int>(k * 2, k));
+        m.insert(mystl::pair<const int, int>(k * 2, k));
+    }
+    for (unsigned threads = 1; threads <= bench_threads(); threads *= 2) {
+        for (int locked = 0; locked < 2; ++locked) {
+            std::atomic<int64_t> hits(0);
+            std::vector<std::thread> workers;
+            auto start = bench_clock::now();
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    uint32_t x = 2463534242u + t;
+                    int64_t local = 0;
+                    for (int i = 0; i < lookups; ++i) {
+                        x ^= x << 13;
+                        x ^= x >> 17;
+                        x ^= x << 5;
+                        const int k = static_cast<int>(x % (2 * keys));
+                        if (locked) {
+                            std::lock_guard<std::mutex> lock(mu);
+                            if (m.find(k) != m.end()) ++local;
+                        } else if (sl.contains(k)) {
+                            ++local;
+                        }
+                    }
+                    hits += local;
+                });
+            }
+            for (auto &w : workers) w.join();
+            const double ms = elapsed_ms(start);
+            std::cout << (locked ? "mutex + map" : "concurrent_skip_list")
+                      << " find, " << threads << " threads";
+            print_result("", uint64_t(threads) * lookups, ms);
+        }
+    }
+}
+
+// timer_wheel：调度100万个定时器，取消一半，以10为步长推进10万个tick；
+// 对照组是按到期时间排序的std::multimap，取消时用保存的迭代器删除
+struct bench_timer : mystl::timer_wheel_entry {
+    uint32_t id;
+};
+
+static void bench_timer_wheel() {
+    const uint32_t n = 1000000;
+    const uint64_t span = 100000, step = 10;
+    std::vector<uint64_t> expires(n);
+    uint32_t x = 88172645u;
+    for (uint32_t i = 0; i < n; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        expires[i] = 1 + x % span;
+    }
+    {
+        std::vector<bench_timer> timers(n);
+        mystl::timer_wheel<bench_timer> wheel;
+        uint64_t fired = 0;
+        auto start = bench_clock::now();
+        for (uint32_t i = 0; i < n; ++i) {
+            timers[i].id = i;
+            wheel.schedule(timers[i], expires[i]);
+        }
+        for (uint32_t i = 0; i < n; i += 2) wheel.cancel(timers[i]);
+        for (uint64_t now = step; now <= span; now += step) {
+            fired += wheel.advance(now, [](bench_timer &) {});
+        }
+        print_result("timer_wheel schedule/cancel/advance", n + n / 2 + fired,
+                     elapsed_ms(start));
+        if (fired != n / 2) std::cout << "  wrong fire count" << std::endl;
+    }
+    {
+        std::multimap<uint64_t, uint32_t> queue;
+        std::vector<std::multimap<uint64_t, uint32_t>::iterator> handles(n);
+        uint64_t fired = 0;
+        auto start = bench_clock::now();
+        for (uint32_t i = 0; i < n; ++i) {
+            handles[i] = queue.emplace(expires[i], i);
+        }
+        for (uint32_t i = 0; i < n; i += 2) queue.erase(handles[i]);
+        for (uint64_t now = step; now <= span; now += step) {
+            while (!queue.empty() && queue.begin()->first <= now) {
+                queue.erase(queue.begin());
+                ++fired;
+            }
+        }
+        print_result("std::multimap schedule/cancel/advance",
+                     n + n / 2 + fired, elapsed_ms(start));
+        if (fired != n / 2) std::cout << "  wrong fire count" << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "threads: " << bench_threads() << std::endl;
+    bench_work_stealing_deque();
+    bench_concurrent_skip_list();
+    bench_timer_wheel();
+    return 0;
+}
@@ -0,0 +1,432 @@
+#pragma once
+
+// 可增长的环形缓冲区：元素放在一块连续内存中，首尾相接
+// 容量为2的幂，下标取模用掩码；head是首元素的位置，count是元素个数。
+// 两端插入删除O(1)且不分配内存，只有容量不够时整体搬到两倍大的新内存，
+// 搬迁时按环绕前后两段分别移动，首元素回到位置0。
+// 批量的push_n/pop_n同样最多分两段拷贝，平凡类型退化为memmove。
+// 作为queue的默认底层容器，FIFO的吞吐接近数组。
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+#include "algobase.h"
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl {
+template <typename T, typename Alloc = mystl::allocator<T>>
+class circular_buffer {
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+
+    // 按逻辑下标访问的随机访问迭代器
+    template <bool Const>
+    class ring_iterator {
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T *, T *>::type;
+        using reference =
+            typename std::conditional<Const, const T &, T &>::type;
+        using owner_pointer =
+            typename std::conditional<Const, const circular_buffer *,
+                                      circular_buffer *>::type;
+
+        ring_iterator() : owner(nullptr), index(0) {}
+        ring_iterator(owner_pointer owner, size_type index)
+            : owner(owner), index(index) {}
+        // iterator可以转换为const_iterator
+        template <bool C,
+                  typename = typename std::enable_if<Const && !C>::type>
+        ring_iterator(const ring_iterator<C> &rhs)
+            : owner(rhs.owner), index(rhs.index) {}
+
+        reference operator*() const { return (*owner)[index]; }
+        pointer operator->() const { return &(*owner)[index]; }
+        reference operator[](difference_type n) const {
+            return (*owner)[index + n];
+        }
+
+        ring_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        ring_iterator operator++(int) {
+            ring_iterator tmp = *this;
+            ++index;
+            return tmp;
+        }
+        ring_iterator &operator--() {
+            --index;
+            return *this;
+        }
+        ring_iterator operator--(int) {
+            ring_iterator tmp = *this;
+            --index;
+            return tmp;
+        }
+        ring_iterator &operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        ring_iterator &operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        ring_iterator operator+(difference_type n) const {
+            return ring_iterator(owner, index + n);
+        }
+        ring_iterator operator-(difference_type n) const {
+            return ring_iterator(owner, index - n);
+        }
+        difference_type operator-(const ring_iterator &rhs) const {
+            return static_cast<difference_type>(index) -
+                   static_cast<difference_type>(rhs.index);
+        }
+
+        bool operator==(const ring_iterator &rhs) const {
+            return index == rhs.index;
+        }
+        bool operator!=(const ring_iterator &rhs) const {
+            return index != rhs.index;
+        }
+        bool operator<(const ring_iterator &rhs) const {
+            return index < rhs.index;
+        }
+        bool operator>(const ring_iterator &rhs) const {
+            return index > rhs.index;
+        }
+        bool operator<=(const ring_iterator &rhs) const {
+            return index <= rhs.index;
+        }
+        bool operator>=(const ring_iterator &rhs) const {
+            return index >= rhs.index;
+        }
+
+       private:
+        template <bool>
+        friend class ring_iterator;
+
+        owner_pointer owner;
+        size_type index;
+    };
+
+    using iterator = ring_iterator<false>;
+    using const_iterator = ring_iterator<true>;
+
+   protected:
+    pointer buf;
+    size_type cap;  // 0或2的幂
+    size_type head;
+    size_type count;
+
+    // 逻辑下标i对应的物理位置
+    size_type slot(size_type i) const { return (head + i) & (cap - 1); }
+
+    // 把全部元素移动到容量为new_cap的新内存，首元素放在位置0
+    void reallocate(size_type new_cap);
+    // 保证还能再放n个元素
+    void ensure_room(size_type n) {
+        if (count + n > cap) {
+            size_type new_cap = cap == 0 ? 8 : cap;
+            while (new_cap < count + n) new_cap <<= 1;
+            reallocate(new_cap);
+        }
+    }
+    void release() {
+        clear();
+        allocator_type::deallocate(buf, cap);
+        buf = nullptr;
+        cap = 0;
+    }
+
+   public:
+    // 构造函数
+    circular_buffer() : buf(nullptr), cap(0), head(0), count(0) {}
+    explicit circular_buffer(size_type n, const value_type &value = T())
+        : circular_buffer() {
+        ensure_room(n);
+        try {
+            mystl::uninitialized_fill_n(buf, n, value);
+        } catch (const std::exception &e) {
+            allocator_type::deallocate(buf, cap);
+            throw;
+        }
+        count = n;
+    }
+    circular_buffer(std::initializer_list<value_type> il) : circular_buffer() {
+        push_n(il.begin(), il.size());
+    }
+    circular_buffer(const circular_buffer &rhs) : circular_buffer() {
+        ensure_room(rhs.count);
+        const size_type first_len =
+            rhs.cap - rhs.head < rhs.count ? rhs.cap - rhs.head : rhs.count;
+        try {
+            pointer mid = mystl::uninitialized_copy(
+                rhs.buf + rhs.head, rhs.buf + rhs.head + first_len, buf);
+            try {
+                mystl::uninitialized_copy(
+                    rhs.buf, rhs.buf + (rhs.count - first_len), mid);
+            } catch (const std::exception &e) {
+                mystl::destroy(buf, mid);
+                throw;
+            }
+        } catch (const std::exception &e) {
+            allocator_type::deallocate(buf, cap);
+            throw;
+        }
+        count = rhs.count;
+    }
+    circular_buffer(circular_buffer &&rhs) noexcept
+        : buf(rhs.buf), cap(rhs.cap), head(rhs.head), count(rhs.count) {
+        rhs.buf = nullptr;
+        rhs.cap = rhs.head = rhs.count = 0;
+    }
+
+    circular_buffer &operator=(const circular_buffer &rhs) {
+        if (this != &rhs) {
+            circular_buffer tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+    circular_buffer &operator=(circular_buffer &&rhs) noexcept {
+        if (this != &rhs) {
+            release();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    // 析构函数
+    ~circular_buffer() { release(); }
+
+    // 迭代器
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, count); }
+    const_iterator end() const { return const_iterator(this, count); }
+    const_iterator cend() const { return end(); }
+
+    // 容量
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_type capacity() const { return cap; }
+    size_type max_size() const {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+    void reserve(size_type n) {
+        if (n > cap) ensure_room(n - count);
+    }
+    void shrink_to_fit() {
+        size_type new_cap = 1;
+        while (new_cap < count) new_cap <<= 1;
+        if (count == 0) {
+            release();
+        } else if (new_cap < cap) {
+            reallocate(new_cap);
+        }
+    }
+
+    // 访问
+    reference operator[](size_type n) { return buf[slot(n)]; }
+    const_reference operator[](size_type n) const { return buf[slot(n)]; }
+    reference at(size_type n) {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "circular_buffer<T>::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "circular_buffer<T>::at");
+        return (*this)[n];
+    }
+    reference front() { return buf[head]; }
+    const_reference front() const { return buf[head]; }
+    reference back() { return buf[slot(count - 1)]; }
+    const_reference back() const { return buf[slot(count - 1)]; }
+
+    // 两端插入删除
+    template <typename... Args>
+    void emplace_back(Args &&...args) {
+        if (count == cap) {
+            // 先在旧内存外构造，args可能引用容器中的元素
+            value_type value(mystl::forward<Args>(args)...);
+            ensure_room(1);
+            mystl::construct(buf + slot(count), mystl::move(value));
+        } else {
+            mystl::construct(buf + slot(count), mystl::forward<Args>(args)...);
+        }
+        ++count;
+    }
+    template <typename... Args>
+    void emplace_front(Args &&...args) {
+        if (count == cap) {
+            value_type value(mystl::forward<Args>(args)...);
+            ensure_room(1);
+            const size_type h = (head - 1) & (cap - 1);
+            mystl::construct(buf + h, mystl::move(value));
+            head = h;
+        } else {
+            const size_type h = (head - 1) & (cap - 1);
+            mystl::construct(buf + h, mystl::forward<Args>(args)...);
+            head = h;
+        }
+        ++count;
+    }
+    void push_back(const value_type &value) { emplace_back(value); }
+    void push_back(value_type &&value) { emplace_back(mystl::move(value)); }
+    void push_front(const value_type &value) { emplace_front(value); }
+    void push_front(value_type &&value) { emplace_front(mystl::move(value)); }
+    void pop_front() {
+        MYSTL_DEBUG(count != 0);
+        mystl::destroy(buf + head);
+        head = (head + 1) & (cap - 1);
+        --count;
+    }
+    void pop_back() {
+        MYSTL_DEBUG(count != 0);
+        mystl::destroy(buf + slot(count - 1));
+        --count;
+    }
+
+    // 批量在尾部追加[first, first + n)，最多分两段拷贝
+    template <typename ForwardIterator>
+    void push_n(ForwardIterator first, size_type n);
+    // 批量从头部取出n个元素，移动赋值到result开始的位置，返回取出的个数
+    template <typename OutputIterator>
+    size_type pop_n(OutputIterator result, size_type n);
+    // 把[pos, pos + n)拷贝到result，不改变容器
+    template <typename OutputIterator>
+    OutputIterator copy_out(size_type pos, size_type n,
+                            OutputIterator result) const;
+
+    void clear() {
+        const size_type first_len = cap - head < count ? cap - head : count;
+        mystl::destroy(buf + head, buf + head + first_len);
+        mystl::destroy(buf, buf + (count - first_len));
+        head = 0;
+        count = 0;
+    }
+    void swap(circular_buffer &rhs) noexcept {
+        mystl::swap(buf, rhs.buf);
+        mystl::swap(cap, rhs.cap);
+        mystl::swap(head, rhs.head);
+        mystl::swap(count, rhs.count);
+    }
+};
+
+template <typename T, typename Alloc>
+void circular_buffer<T, Alloc>::reallocate(size_type new_cap) {
+    pointer new_buf = allocator_type::allocate(new_cap);
+    const size_type first_len = cap - head < count ? cap - head : count;
+    try {
+        pointer mid =
+            mystl::uninitialized_move(buf + head, buf + head + first_len,
+                                      new_buf);
+        try {
+            mystl::uninitialized_move(buf, buf + (count - first_len), mid);
+        } catch (const std::exception &e) {
+            mystl::destroy(new_buf, mid);
+            throw;
+        }
+    } catch (const std::exception &e) {
+        allocator_type::deallocate(new_buf, new_cap);
+        throw;
+    }
+    const size_type n = count;
+    clear();
+    allocator_type::deallocate(buf, cap);
+    buf = new_buf;
+    cap = new_cap;
+    head = 0;
+    count = n;
+}
+
+template <typename T, typename Alloc>
+template <typename ForwardIterator>
+void circular_buffer<T, Alloc>::push_n(ForwardIterator first, size_type n) {
+    ensure_room(n);
+    const size_type pos = slot(count);
+    const size_type len = cap - pos < n ? cap - pos : n;
+    ForwardIterator mid = first;
+    mystl::advance(mid, len);
+    mystl::uninitialized_copy(first, mid, buf + pos);
+    try {
+        ForwardIterator last = mid;
+        mystl::advance(last, n - len);
+        mystl::uninitialized_copy(mid, last, buf);
+    } catch (const std::exception &e) {
+        mystl::destroy(buf + pos, buf + pos + len);
+        throw;
+    }
+    count += n;
+}
+
+template <typename T, typename Alloc>
+template <typename OutputIterator>
+typename circular_buffer<T, Alloc>::size_type circular_buffer<T, Alloc>::pop_n(
+    OutputIterator result, size_type n) {
+    if (n > count) n = count;
+    const size_type len = cap - head < n ? cap - head : n;
+    result = mystl::move(buf + head, buf + head + len, result);
+    mystl::move(buf, buf + (n - len), result);
+    mystl::destroy(buf + head, buf + head + len);
+    mystl::destroy(buf, buf + (n - len));
+    head = n == 0 ? head : (head + n) & (cap - 1);
+    count -= n;
+    return n;
+}
+
+template <typename T, typename Alloc>
+template <typename OutputIterator>
+OutputIterator circular_buffer<T, Alloc>::copy_out(
+    size_type pos, size_type n, OutputIterator result) const {
+    MYSTL_OUT_OF_RANGE_IF(pos > count || n > count - pos,
+                          "circular_buffer<T>::copy_out");
+    if (n == 0) return result;
+    const size_type start = slot(pos);
+    const size_type len = cap - start < n ? cap - start : n;
+    result = mystl::copy(buf + start, buf + start + len, result);
+    return mystl::copy(buf, buf + (n - len), result);
+}
+
+template <typename T, typename Alloc>
+bool operator==(const circular_buffer<T, Alloc> &lhs,
+                const circular_buffer<T, Alloc> &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (!(lhs[i] == rhs[i])) return false;
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+bool operator!=(const circular_buffer<T, Alloc> &lhs,
+                const circular_buffer<T, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc>
+bool operator<(const circular_buffer<T, Alloc> &lhs,
+               const circular_buffer<T, Alloc> &rhs) {
+    const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (lhs[i] < rhs[i]) return true;
+        if (rhs[i] < lhs[i]) return false;
+    }
+    return lhs.size() < rhs.size();
+}
+}  // namespace mystl
@@ -0,0 +1,804 @@
+#pragma once
+
+// 无锁有序跳表(Harris链表 + Herlihy/Shavit跳表 + 基于epoch的内存回收)
+// insert/find/erase都不加锁。每层的next指针最低位是删除标记：
+// erase先从顶层到第0层逐层打标记，第0层标记成功的线程赢得删除，
+// 之后的搜索遇到带标记的节点就用CAS把它从该层摘掉。
+// 查找(find/contains/lower_bound/迭代)只读不写，跳过带标记的节点，
+// 读多写少时各线程之间没有共享写，可以接近线性扩展。
+// 被摘掉的节点不能马上释放，其他线程可能还拿着它的指针：
+// 每个操作期间线程处于一个epoch中，节点退休时记下当时的全局epoch，
+// 等全局epoch前进两次(所有活跃线程都已离开那个epoch)后才释放。
+// 指向元素的迭代器也持有epoch，它活着时本线程看到的节点都不会被释放，
+// 所以迭代器不能跨线程传递，也不宜长期保存，否则内存迟迟得不到回收。
+// end()和默认构造的迭代器不持有epoch，可以随意保存。
+// 迭代是弱一致的：遍历期间并发插入或删除的元素可能看得到也可能看不到。
+// map的mapped值并发修改需要使用者自己同步(例如存放原子类型)。
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "util.h"
+
+namespace mystl {
+namespace detail {
+// 可以交给epoch回收的对象，退休链表直接挂在对象自己身上
+struct epoch_reclaimable {
+    epoch_reclaimable *retired_next;
+    uint64_t retire_epoch;
+    void (*reclaim)(epoch_reclaimable *);
+};
+
+class epoch_domain {
+   public:
+    static constexpr size_t max_threads = 256;
+    // 每退休这么多个节点尝试推进一次epoch
+    static constexpr size_t reclaim_batch = 64;
+
+    static epoch_domain &instance() {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    ~epoch_domain() {
+        // 此时所有线程都已退出，孤儿链表上的节点可以直接释放
+        free_list(orphans);
+    }
+
+    // 每个线程一份，线程退出时把没释放完的节点交给全局的孤儿链表
+    struct thread_state {
+        size_t slot = max_threads;
+        size_t nesting = 0;
+        epoch_reclaimable *limbo = nullptr;
+        size_t limbo_size = 0;
+
+        ~thread_state() {
+            if (slot == max_threads) return;
+            epoch_domain &d = instance();
+            d.reclaim(*this);
+            if (limbo) {
+                std::lock_guard<std::mutex> lock(d.orphan_mutex);
+                epoch_reclaimable *tail = limbo;
+                while (tail->retired_next) tail = tail->retired_next;
+                tail->retired_next = d.orphans;
+                d.orphans = limbo;
+                d.has_orphans.store(true, std::memory_order_relaxed);
+            }
+            d.slots[slot].used.store(false, std::memory_order_release);
+        }
+    };
+
+    static thread_state &local() {
+        static thread_local thread_state state;
+        return state;
+    }
+
+    void enter(thread_state &ts) {
+        if (ts.nesting++ != 0) return;
+        if (ts.slot == max_threads) acquire_slot(ts);
+        slot &s = slots[ts.slot];
+        s.epoch.store(global_epoch.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+        // 之后对共享节点的读取不能排到公布epoch之前
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void leave(thread_state &ts) {
+        if (--ts.nesting != 0) return;
+        slots[ts.slot].epoch.store(0, std::memory_order_release);
+    }
+
+    // 调用时对象必须已经从所有共享结构中摘除
+    void retire(thread_state &ts, epoch_reclaimable *p) {
+        p->retire_epoch = global_epoch.load(std::memory_order_seq_cst);
+        p->retired_next = ts.limbo;
+        ts.limbo = p;
+        if (++ts.limbo_size >= reclaim_batch) {
+            try_advance();
+            reclaim(ts);
+        }
+    }
+
+   private:
+    struct alignas(cache_line_size) slot {
+        std::atomic<uint64_t> epoch{0};  // 0表示不在临界区
+        std::atomic<bool> used{false};
+    };
+
+    alignas(cache_line_size) std::atomic<uint64_t> global_epoch{1};
+    slot slots[max_threads];
+    std::atomic<bool> has_orphans{false};
+    std::mutex orphan_mutex;
+    epoch_reclaimable *orphans = nullptr;
+
+    epoch_domain() = default;
+
+    static void free_list(epoch_reclaimable *p) {
+        while (p) {
+            epoch_reclaimable *next = p->retired_next;
+            p->reclaim(p);
+            p = next;
+        }
+    }
+
+    void acquire_slot(thread_state &ts) {
+        for (size_t i = 0; i < max_threads; ++i) {
+            bool expected = false;
+            if (!slots[i].used.load(std::memory_order_relaxed) &&
+                slots[i].used.compare_exchange_strong(
+                    expected, true, std::memory_order_acquire)) {
+                ts.slot = i;
+                return;
+            }
+        }
+        --ts.nesting;
+        MYSTL_RUNTIME_ERROR_IF(true, "epoch_domain: too many threads");
+    }
+
+    // 所有活跃线程都已进入当前epoch时才能前进
+    void try_advance() {
+        uint64_t e = global_epoch.load(std::memory_order_seq_cst);
+        for (size_t i = 0; i < max_threads; ++i) {
+            uint64_t local = slots[i].epoch.load(std::memory_order_seq_cst);
+            if (local != 0 && local != e) return;
+        }
+        global_epoch.compare_exchange_strong(e, e + 1,
+                                             std::memory_order_seq_cst);
+    }
+
+    // 退休于e的对象在全局epoch达到e + 2后不可能再被任何线程引用
+    void reclaim(thread_state &ts) {
+        uint64_t e = global_epoch.load(std::memory_order_acquire);
+        epoch_reclaimable **link = &ts.limbo;
+        while (*link) {
+            epoch_reclaimable *p = *link;
+            if (p->retire_epoch + 2 <= e) {
+                *link = p->retired_next;
+                p->reclaim(p);
+                --ts.limbo_size;
+            } else {
+                link = &p->retired_next;
+            }
+        }
+        if (has_orphans.load(std::memory_order_relaxed)) {
+            std::unique_lock<std::mutex> lock(orphan_mutex, std::try_to_lock);
+            if (!lock.owns_lock()) return;
+            link = &orphans;
+            while (*link) {
+                epoch_reclaimable *p = *link;
+                if (p->retire_epoch + 2 <= e) {
+                    *link = p->retired_next;
+                    p->reclaim(p);
+                } else {
+                    link = &p->retired_next;
+                }
+            }
+            has_orphans.store(orphans != nullptr, std::memory_order_relaxed);
+        }
+    }
+};
+
+// 作用域内本线程看到的节点不会被释放，可以嵌套。
+// active为false时不进入epoch；拷贝得到的guard与原来的是否进入一致
+class epoch_guard {
+   public:
+    epoch_guard() : epoch_guard(true) {}
+    explicit epoch_guard(bool active) : state(nullptr) {
+        if (active) enter();
+    }
+    epoch_guard(const epoch_guard &rhs) : epoch_guard(rhs.active()) {}
+    epoch_guard &operator=(const epoch_guard &rhs) {
+        if (rhs.active()) {
+            enter();
+        } else {
+            leave();
+        }
+        return *this;
+    }
+    ~epoch_guard() { leave(); }
+
+    bool active() const { return state != nullptr; }
+    void enter() {
+        if (state) return;
+        state = &epoch_domain::local();
+        epoch_domain::instance().enter(*state);
+    }
+    void leave() {
+        if (!state) return;
+        epoch_domain::instance().leave(*state);
+        state = nullptr;
+    }
+
+    epoch_domain::thread_state &thread() const { return *state; }
+
+   private:
+    epoch_domain::thread_state *state;
+};
+
+template <class Key>
+struct skip_list_identity {
+    const Key &operator()(const Key &k) const { return k; }
+};
+
+template <class Pair>
+struct skip_list_select_first {
+    const typename Pair::first_type &operator()(const Pair &p) const {
+        return p.first;
+    }
+};
+
+// 节点的各层next指针紧跟在节点后面，和节点一起分配
+struct skip_list_node_base : epoch_reclaimable {
+    int height;
+    // 插入线程和删除线程各持有一份，最后放手的一方负责退休节点
+    std::atomic<int> owners;
+    std::atomic<uintptr_t> *links;
+};
+
+template <class Value>
+struct skip_list_node : skip_list_node_base {
+    Value value;
+};
+}  // namespace detail
+
+template <class Value, bool Const>
+class concurrent_skip_list_iterator;
+
+template <class Key, class Value, class KeyOfValue,
+          class Compare = mystl::less<Key>>
+class concurrent_skip_list {
+   public:
+    using key_type = Key;
+    using value_type = Value;
+    using key_compare = Compare;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+
+    // set的元素就是键，不允许通过迭代器修改
+    using iterator = concurrent_skip_list_iterator<
+        Value, std::is_same<Key, Value>::value>;
+    using const_iterator = concurrent_skip_list_iterator<Value, true>;
+
+    static constexpr int max_height = 24;
+
+   private:
+    using base_type = detail::skip_list_node_base;
+    using node_type = detail::skip_list_node<Value>;
+    using link_type = std::atomic<uintptr_t>;
+    using byte_alloc = mystl::allocator<unsigned char>;
+
+    base_type *head;
+    // 当前最高的层数，只增不减，搜索从这一层开始
+    std::atomic<int> top;
+    std::atomic<size_type> node_count;
+    key_compare comp;
+    KeyOfValue key_of;
+
+    static base_type *ptr(uintptr_t raw) {
+        return reinterpret_cast<base_type *>(raw & ~uintptr_t(1));
+    }
+    static uintptr_t raw(base_type *p) { return reinterpret_cast<uintptr_t>(p); }
+    static bool marked(uintptr_t raw) { return raw & 1; }
+
+    const key_type &key(base_type *p) const {
+        return key_of(static_cast<node_type *>(p)->value);
+    }
+
+    static size_t node_bytes(size_t header, int height) {
+        return header + sizeof(link_type) * height;
+    }
+
+    template <class Node>
+    static Node *allocate_node(int height) {
+        unsigned char *mem = byte_alloc::allocate(node_bytes(sizeof(Node), height));
+        Node *p = reinterpret_cast<Node *>(mem);
+        p->height = height;
+        p->owners.store(2, std::memory_order_relaxed);
+        p->links = reinterpret_cast<link_type *>(mem + sizeof(Node));
+        for (int i = 0; i < height; ++i) {
+            ::new (static_cast<void *>(p->links + i)) link_type(0);
+        }
+        return p;
+    }
+
+    static void deallocate_node(base_type *p, size_t header) {
+        byte_alloc::deallocate(reinterpret_cast<unsigned char *>(p),
+                               node_bytes(header, p->height));
+    }
+
+    static void destroy_node(detail::epoch_reclaimable *r) {
+        node_type *p = static_cast<node_type *>(r);
+        mystl::destroy(&p->value);
+        deallocate_node(p, sizeof(node_type));
+    }
+
+    template <class... Args>
+    node_type *create_node(Args &&...args) {
+        node_type *p = allocate_node<node_type>(random_height());
+        try {
+            mystl::construct(&p->value, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_node(p, sizeof(node_type));
+            throw;
+        }
+        p->reclaim = &destroy_node;
+        return p;
+    }
+
+    // 每层以1/4的概率继续向上
+    static int random_height() {
+        static thread_local uint64_t state =
+            0x9e3779b97f4a7c15ull ^ reinterpret_cast<uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        uint64_t bits = state;
+        int h = 1;
+        while (h < max_height && (bits & 3) == 0) {
+            ++h;
+            bits >>= 2;
+        }
+        return h;
+    }
+
+    void raise_top(int height) {
+        int t = top.load(std::memory_order_relaxed);
+        while (t < height &&
+               !top.compare_exchange_weak(t, height, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+        }
+    }
+
+    static base_type *first_live(base_type *p) {
+        base_type *curr = ptr(p->links[0].load(std::memory_order_acquire));
+        while (curr && marked(curr->links[0].load(std::memory_order_acquire))) {
+            curr = ptr(curr->links[0].load(std::memory_order_acquire));
+        }
+        return curr;
+    }
+
+    // 只读搜索：返回第一个未删除且键不小于k的节点
+    base_type *search_lower(const key_type &k) const {
+        base_type *pred = head;
+        base_type *curr = nullptr;
+        for (int level = top.load(std::memory_order_acquire) - 1; level >= 0;
+             --level) {
+            curr = ptr(pred->links[level].load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t next = curr->links[level].load(std::memory_order_acquire);
+                if (marked(next)) {
+                    curr = ptr(next);
+                } else if (comp(key(curr), k)) {
+                    pred = curr;
+                    curr = ptr(next);
+                } else {
+                    break;
+                }
+            }
+        }
+        return curr;
+    }
+
+    base_type *search_upper(const key_type &k) const {
+        base_type *pred = head;
+        base_type *curr = nullptr;
+        for (int level = top.load(std::memory_order_acquire) - 1; level >= 0;
+             --level) {
+            curr = ptr(pred->links[level].load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t next = curr->links[level].load(std::memory_order_acquire);
+                if (marked(next)) {
+                    curr = ptr(next);
+                } else if (!comp(k, key(curr))) {
+                    pred = curr;
+                    curr = ptr(next);
+                } else {
+                    break;
+                }
+            }
+        }
+        return curr;
+    }
+
+    // 摘掉经过的已删除节点，填好每层的前驱和后继；
+    // 返回第0层的后继是否就是键k
+    bool find(const key_type &k, base_type **preds, base_type **succs) {
+    retry:
+        // top之上的层还是空的；别人刚接入更高层时接入CAS会失败并重新搜索
+        int t = top.load(std::memory_order_acquire);
+        for (int level = max_height - 1; level >= t; --level) {
+            preds[level] = head;
+            succs[level] = nullptr;
+        }
+        base_type *pred = head;
+        for (int level = t - 1; level >= 0; --level) {
+            base_type *curr =
+                ptr(pred->links[level].load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t next = curr->links[level].load(std::memory_order_acquire);
+                if (marked(next)) {
+                    uintptr_t expected = raw(curr);
+                    if (!pred->links[level].compare_exchange_strong(
+                            expected, raw(ptr(next)), std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        goto retry;
+                    }
+                    curr = ptr(next);
+                } else if (comp(key(curr), k)) {
+                    pred = curr;
+                    curr = ptr(next);
+                } else {
+                    break;
+                }
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return succs[0] && !comp(k, key(succs[0]));
+    }
+
+    // 保证节点p(各层都已打上删除标记)从所有层摘除。
+    // 同一个键可能同时有一个新节点和一个还没摘干净的旧节点，新节点在前，
+    // 所以这里要越过键相等的其他节点，直到遇见p本身
+    void unlink(base_type *p) {
+        const key_type &k = key(p);
+        // 从顶层往下走才能快速定位；插入线程可能还没来得及提升top
+        int t = top.load(std::memory_order_acquire);
+        if (t < p->height) t = p->height;
+    retry:
+        base_type *pred = head;
+        for (int level = t - 1; level >= 0; --level) {
+            base_type *curr =
+                ptr(pred->links[level].load(std::memory_order_acquire));
+            while (curr) {
+                uintptr_t next = curr->links[level].load(std::memory_order_acquire);
+                if (marked(next)) {
+                    uintptr_t expected = raw(curr);
+                    if (!pred->links[level].compare_exchange_strong(
+                            expected, raw(ptr(next)), std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                        goto retry;
+                    }
+                    curr = ptr(next);
+                } else if (curr != p && !comp(k, key(curr))) {
+                    pred = curr;
+                    curr = ptr(next);
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    void release(detail::epoch_guard &guard, base_type *p) {
+        if (p->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            detail::epoch_domain::instance().retire(guard.thread(), p);
+        }
+    }
+
+    // p还没有发布时可以直接释放
+    static void discard(node_type *p) { destroy_node(p); }
+
+    // 把新节点接到第0层之上的各层，期间节点可能已被删除
+    void link_upper(detail::epoch_guard &guard, node_type *p, base_type **preds,
+                    base_type **succs) {
+        const key_type &k = key(p);
+        for (int level = 1; level < p->height; ++level) {
+            for (;;) {
+                uintptr_t old = p->links[level].load(std::memory_order_acquire);
+                if (marked(old)) goto done;
+                base_type *succ = succs[level];
+                // 重新搜索后后继可能变了；失败说明节点刚被打上标记
+                if (old != raw(succ) &&
+                    !p->links[level].compare_exchange_strong(
+                        old, raw(succ), std::memory_order_acq_rel,
+                        std::memory_order_acquire)) {
+                    goto done;
+                }
+                uintptr_t expected = raw(succ);
+                if (preds[level]->links[level].compare_exchange_strong(
+                        expected, raw(p), std::memory_order_acq_rel,
+                        std::memory_order_acquire)) {
+                    break;
+                }
+                find(k, preds, succs);
+            }
+        }
+    done:
+        // 删除线程的unlink可能早于这里的接入，由插入线程再摘一次
+        if (marked(p->links[0].load(std::memory_order_acquire))) unlink(p);
+        release(guard, p);
+    }
+
+    mystl::pair<iterator, bool> insert_node(node_type *p) {
+        detail::epoch_guard guard;
+        base_type *preds[max_height];
+        base_type *succs[max_height];
+        const key_type &k = key(p);
+        for (;;) {
+            if (find(k, preds, succs)) {
+                iterator it(succs[0]);
+                discard(p);
+                return mystl::pair<iterator, bool>(it, false);
+            }
+            for (int i = 0; i < p->height; ++i) {
+                p->links[i].store(raw(succs[i]), std::memory_order_relaxed);
+            }
+            uintptr_t expected = raw(succs[0]);
+            // 第0层接入成功即插入生效
+            if (preds[0]->links[0].compare_exchange_strong(
+                    expected, raw(p), std::memory_order_release,
+                    std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        node_count.fetch_add(1, std::memory_order_relaxed);
+        raise_top(p->height);
+        iterator it(p);
+        link_upper(guard, p, preds, succs);
+        return mystl::pair<iterator, bool>(it, true);
+    }
+
+    // 从顶层往下逐层打标记，第0层标记成功的线程赢得删除
+    bool erase_node(detail::epoch_guard &guard, base_type *p) {
+        for (int level = p->height - 1; level >= 1; --level) {
+            uintptr_t next = p->links[level].load(std::memory_order_acquire);
+            while (!marked(next) &&
+                   !p->links[level].compare_exchange_weak(
+                       next, next | 1, std::memory_order_acq_rel,
+                       std::memory_order_acquire)) {
+            }
+        }
+        uintptr_t next = p->links[0].load(std::memory_order_acquire);
+        for (;;) {
+            if (marked(next)) return false;
+            if (p->links[0].compare_exchange_weak(next, next | 1,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                break;
+            }
+        }
+        node_count.fetch_sub(1, std::memory_order_relaxed);
+        unlink(p);
+        release(guard, p);
+        return true;
+    }
+
+   public:
+    concurrent_skip_list() : concurrent_skip_list(key_compare()) {}
+
+    explicit concurrent_skip_list(const key_compare &comp)
+        : head(allocate_node<base_type>(max_height)),
+          top(1),
+          node_count(0),
+          comp(comp) {}
+
+    template <class InputIterator>
+    concurrent_skip_list(InputIterator first, InputIterator last)
+        : concurrent_skip_list() {
+        insert(first, last);
+    }
+
+    concurrent_skip_list(std::initializer_list<value_type> il)
+        : concurrent_skip_list() {
+        insert(il.begin(), il.end());
+    }
+
+    concurrent_skip_list(const concurrent_skip_list &) = delete;
+    concurrent_skip_list &operator=(const concurrent_skip_list &) = delete;
+
+    // 析构时不能再有其他线程访问；已删除的节点都交给了epoch回收，
+    // 仍挂在第0层上的节点都是有效元素
+    ~concurrent_skip_list() {
+        base_type *p = ptr(head->links[0].load(std::memory_order_acquire));
+        while (p) {
+            base_type *next = ptr(p->links[0].load(std::memory_order_relaxed));
+            destroy_node(p);
+            p = next;
+        }
+        deallocate_node(head, sizeof(base_type));
+    }
+
+    key_compare key_comp() const { return comp; }
+
+    // 并发修改时只是近似值
+    size_type size() const { return node_count.load(std::memory_order_relaxed); }
+    bool empty() const { return begin() == end(); }
+
+    iterator begin() {
+        detail::epoch_guard guard;
+        return iterator(first_live(head));
+    }
+    const_iterator begin() const {
+        detail::epoch_guard guard;
+        return const_iterator(first_live(head));
+    }
+    iterator end() { return iterator(nullptr); }
+    const_iterator end() const { return const_iterator(nullptr); }
+
+    // 键已存在时不插入，返回已有元素
+    mystl::pair<iterator, bool> insert(const value_type &value) {
+        {
+            detail::epoch_guard guard;
+            base_type *p = search_lower(key_of(value));
+            if (p && !comp(key_of(value), key(p))) {
+                return mystl::pair<iterator, bool>(iterator(p), false);
+            }
+        }
+        return insert_node(create_node(value));
+    }
+
+    mystl::pair<iterator, bool> insert(value_type &&value) {
+        {
+            detail::epoch_guard guard;
+            base_type *p = search_lower(key_of(value));
+            if (p && !comp(key_of(value), key(p))) {
+                return mystl::pair<iterator, bool>(iterator(p), false);
+            }
+        }
+        return insert_node(create_node(std::move(value)));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace(Args &&...args) {
+        return insert_node(create_node(std::forward<Args>(args)...));
+    }
+
+    size_type erase(const key_type &k) {
+        detail::epoch_guard guard;
+        base_type *preds[max_height];
+        base_type *succs[max_height];
+        for (;;) {
+            if (!find(k, preds, succs)) return 0;
+            // 被别人抢先删除时重新找，键可能已经被重新插入
+            if (erase_node(guard, succs[0])) return 1;
+        }
+    }
+
+    // 删除迭代器指向的那个元素，它已被别人删除时返回false
+    bool erase(const_iterator pos) {
+        detail::epoch_guard guard;
+        return erase_node(guard, pos.node);
+    }
+
+    // 逐个删除，可以与其他操作并发
+    void clear() {
+        for (iterator it = begin(); it != end(); ++it) erase(const_iterator(it));
+    }
+
+    iterator find(const key_type &k) {
+        detail::epoch_guard guard;
+        base_type *p = search_lower(k);
+        return iterator(p && !comp(k, key(p)) ? p : nullptr);
+    }
+    const_iterator find(const key_type &k) const {
+        detail::epoch_guard guard;
+        base_type *p = search_lower(k);
+        return const_iterator(p && !comp(k, key(p)) ? p : nullptr);
+    }
+
+    bool contains(const key_type &k) const {
+        detail::epoch_guard guard;
+        base_type *p = search_lower(k);
+        return p && !comp(k, key(p));
+    }
+    size_type count(const key_type &k) const { return contains(k) ? 1 : 0; }
+
+    iterator lower_bound(const key_type &k) {
+        detail::epoch_guard guard;
+        return iterator(search_lower(k));
+    }
+    const_iterator lower_bound(const key_type &k) const {
+        detail::epoch_guard guard;
+        return const_iterator(search_lower(k));
+    }
+
+    iterator upper_bound(const key_type &k) {
+        detail::epoch_guard guard;
+        return iterator(search_upper(k));
+    }
+    const_iterator upper_bound(const key_type &k) const {
+        detail::epoch_guard guard;
+        return const_iterator(search_upper(k));
+    }
+
+    mystl::pair<iterator, iterator> equal_range(const key_type &k) {
+        return mystl::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range(
+        const key_type &k) const {
+        return mystl::pair<const_iterator, const_iterator>(lower_bound(k),
+                                                           upper_bound(k));
+    }
+};
+
+// 指向元素时持有epoch，存活期间指向的节点不会被释放；
+// 走到end()时放开epoch
+template <class Value, bool Const>
+class concurrent_skip_list_iterator {
+    template <class, class, class, class>
+    friend class concurrent_skip_list;
+    friend class concurrent_skip_list_iterator<Value, !Const>;
+
+    using base_type = detail::skip_list_node_base;
+    using node_type = detail::skip_list_node<Value>;
+
+   public:
+    using iterator_category = forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::conditional<Const, const Value *, Value *>::type;
+    using reference = typename std::conditional<Const, const Value &, Value &>::type;
+
+    concurrent_skip_list_iterator() : guard(false), node(nullptr) {}
+    explicit concurrent_skip_list_iterator(base_type *p)
+        : guard(p != nullptr), node(p) {}
+    // iterator可以转换成const_iterator
+    template <bool C = Const, typename std::enable_if<C, int>::type = 0>
+    concurrent_skip_list_iterator(
+        const concurrent_skip_list_iterator<Value, false> &rhs)
+        : guard(rhs.guard), node(rhs.node) {}
+
+    reference operator*() const { return static_cast<node_type *>(node)->value; }
+    pointer operator->() const { return &operator*(); }
+
+    // 跳过已打删除标记的节点
+    concurrent_skip_list_iterator &operator++() {
+        uintptr_t next = node->links[0].load(std::memory_order_acquire);
+        node = reinterpret_cast<base_type *>(next & ~uintptr_t(1));
+        while (node) {
+            next = node->links[0].load(std::memory_order_acquire);
+            if (!(next & 1)) break;
+            node = reinterpret_cast<base_type *>(next & ~uintptr_t(1));
+        }
+        if (!node) guard.leave();
+        return *this;
+    }
+    concurrent_skip_list_iterator operator++(int) {
+        concurrent_skip_list_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const concurrent_skip_list_iterator &rhs) const {
+        return node == rhs.node;
+    }
+    bool operator!=(const concurrent_skip_list_iterator &rhs) const {
+        return node != rhs.node;
+    }
+
+   private:
+    detail::epoch_guard guard;  // 与node != nullptr一致
+    base_type *node;
+};
+
+template <class Key, class T, class Compare = mystl::less<Key>>
+using concurrent_skip_list_map =
+    concurrent_skip_list<Key, mystl::pair<const Key, T>,
+                         detail::skip_list_select_first<mystl::pair<const Key, T>>,
+                         Compare>;
+
+template <class Key, class Compare = mystl::less<Key>>
+using concurrent_skip_list_set =
+    concurrent_skip_list<Key, Key, detail::skip_list_identity<Key>, Compare>;
+
+}  // namespace mystl
@@ -0,0 +1,397 @@
+#pragma once
+
+// 分段向量，元素地址在整个生命周期内不变
+// 第k段容量为first_segment_size << k，下标通过最高位计算段号，O(1)访问且扩容不搬移元素。
+// push_back/grow_by可以由多个线程并发调用(无锁)，读者也可以同时按下标访问：
+// 只能访问自己或其他线程已经构造完成的元素(例如通过push_back返回的下标得知)，
+// size()统计的是已分配出去的下标，其中可能有元素正在构造；
+// 每个下标有一个就绪标记，构造成功后才置位。元素构造抛出异常时该下标仍被占用
+// 但没有元素，不能再访问它，析构和clear只析构已就绪的元素。
+// 析构、clear、赋值等其他操作不能与任何并发操作同时进行。
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace mystl {
+template <typename T, typename Alloc = mystl::allocator<T>>
+class concurrent_vector {
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+
+    // 第0段的元素个数取2的幂，之后每段翻倍
+    static constexpr size_type first_segment_shift = 5;
+    static constexpr size_type first_segment_size = size_type(1)
+                                                    << first_segment_shift;
+    static constexpr size_type max_segments =
+        sizeof(size_type) * 8 - first_segment_shift;
+
+    // 按下标访问的随机访问迭代器
+    template <bool Const>
+    class segment_iterator {
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = typename std::conditional<Const, const T *, T *>::type;
+        using reference =
+            typename std::conditional<Const, const T &, T &>::type;
+        using owner_pointer =
+            typename std::conditional<Const, const concurrent_vector *,
+                                      concurrent_vector *>::type;
+
+        segment_iterator() : owner(nullptr), index(0) {}
+        segment_iterator(owner_pointer owner, size_type index)
+            : owner(owner), index(index) {}
+
+        reference operator*() const { return (*owner)[index]; }
+        pointer operator->() const { return &(*owner)[index]; }
+        reference operator[](difference_type n) const {
+            return (*owner)[index + n];
+        }
+
+        segment_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        segment_iterator operator++(int) {
+            segment_iterator tmp = *this;
+            ++index;
+            return tmp;
+        }
+        segment_iterator &operator--() {
+            --index;
+            return *this;
+        }
+        segment_iterator operator--(int) {
+            segment_iterator tmp = *this;
+            --index;
+            return tmp;
+        }
+        segment_iterator &operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        segment_iterator &operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        segment_iterator operator+(difference_type n) const {
+            return segment_iterator(owner, index + n);
+        }
+        segment_iterator operator-(difference_type n) const {
+            return segment_iterator(owner, index - n);
+        }
+        difference_type operator-(const segment_iterator &rhs) const {
+            return static_cast<difference_type>(index) -
+                   static_cast<difference_type>(rhs.index);
+        }
+
+        bool operator==(const segment_iterator &rhs) const {
+            return index == rhs.index;
+        }
+        bool operator!=(const segment_iterator &rhs) const {
+            return index != rhs.index;
+        }
+        bool operator<(const segment_iterator &rhs) const {
+            return index < rhs.index;
+        }
+
+       private:
+        owner_pointer owner;
+        size_type index;
+    };
+
+    using iterator = segment_iterator<false>;
+    using const_iterator = segment_iterator<true>;
+
+   protected:
+    using flag_type = std::atomic<unsigned char>;
+
+    // 段表与下标计数器分处不同缓存行，追加时的计数器争用不影响读者
+    // 每段的就绪标记数组紧跟在元素之后，与段一起分配
+    std::atomic<pointer> segments[max_segments];
+    alignas(cache_line_size) std::atomic<size_type> count;
+
+    // 辅助函数
+    static size_type log2_floor(size_type x) {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 -
+               static_cast<size_type>(
+                   __builtin_clzll(static_cast<unsigned long long>(x)));
+#else
+        size_type r = 0;
+        while (x >>= 1) ++r;
+        return r;
+#endif
+    }
+    static size_type segment_size(size_type k) {
+        return first_segment_size << k;
+    }
+    // 下标加上first_segment_size后，最高位决定段号，其余位是段内偏移
+    static size_type segment_index(size_type n) {
+        return log2_floor(n + first_segment_size) - first_segment_shift;
+    }
+    static size_type segment_offset(size_type n) {
+        const size_type j = n + first_segment_size;
+        return j - (size_type(1) << log2_floor(j));
+    }
+    // 段的分配长度(以T计)，包括末尾的就绪标记
+    static size_type segment_alloc_size(size_type k) {
+        return segment_size(k) +
+               (segment_size(k) * sizeof(flag_type) + sizeof(T) - 1) /
+                   sizeof(T);
+    }
+    static flag_type *segment_flags(pointer segment, size_type k) {
+        return reinterpret_cast<flag_type *>(segment + segment_size(k));
+    }
+    flag_type &ready_flag(size_type n) {
+        const size_type k = segment_index(n);
+        return segment_flags(segments[k].load(std::memory_order_acquire),
+                             k)[segment_offset(n)];
+    }
+    bool is_ready(size_type n) const {
+        const size_type k = segment_index(n);
+        pointer p = segments[k].load(std::memory_order_acquire);
+        return p != nullptr &&
+               segment_flags(p, k)[segment_offset(n)].load(
+                   std::memory_order_acquire) != 0;
+    }
+
+    // 先检查长度再占用n个下标，返回第一个
+    size_type reserve_slots(size_type n);
+
+    // 保证第k段已经分配，多个线程竞争时只有一个的分配会被采用
+    pointer ensure_segment(size_type k);
+    // 保证[first, last)所在的段都已分配
+    void ensure_range(size_type first, size_type last);
+
+    void init();
+    void release();
+
+   public:
+    // 构造函数
+    concurrent_vector() { init(); }
+    explicit concurrent_vector(size_type n, const value_type &value = T()) {
+        init();
+        grow_by(n, value);
+    }
+    concurrent_vector(const concurrent_vector &rhs) {
+        init();
+        const size_type n = rhs.size();
+        try {
+            ensure_range(0, n);
+            count.store(n, std::memory_order_relaxed);
+            // rhs中构造失败留下的空位照样保留为空位
+            for (size_type i = 0; i < n; ++i) {
+                if (!rhs.is_ready(i)) continue;
+                allocator_type::construct(&(*this)[i], rhs[i]);
+                ready_flag(i).store(1, std::memory_order_relaxed);
+            }
+        } catch (const std::exception &e) {
+            release();
+            std::cerr << e.what() << '\n';
+            throw;
+        }
+    }
+    concurrent_vector &operator=(const concurrent_vector &rhs) {
+        if (this != &rhs) {
+            concurrent_vector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 析构函数
+    ~concurrent_vector() { release(); }
+
+    // 迭代器，end()取调用时的size()
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // 容量
+    size_type size() const { return count.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    size_type max_size() const {
+        return static_cast<size_type>(-1) - first_segment_size;
+    }
+
+    // 访问，无锁
+    reference operator[](size_type n) {
+        return segments[segment_index(n)].load(std::memory_order_acquire)
+            [segment_offset(n)];
+    }
+    const_reference operator[](size_type n) const {
+        return segments[segment_index(n)].load(std::memory_order_acquire)
+            [segment_offset(n)];
+    }
+    reference at(size_type n) {
+        MYSTL_OUT_OF_RANGE_IF(n >= size(), "concurrent_vector<T>::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= size(), "concurrent_vector<T>::at");
+        return (*this)[n];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+
+    // 并发追加，返回新元素的下标
+    size_type push_back(const value_type &value) { return emplace_back(value); }
+    size_type push_back(value_type &&value) {
+        return emplace_back(mystl::move(value));
+    }
+    template <typename... Args>
+    size_type emplace_back(Args &&...args);
+
+    // 并发追加n个value，返回第一个新元素的下标
+    size_type grow_by(size_type n, const value_type &value = T());
+
+    // 以下操作不能与其他操作并发
+    void clear();
+    void swap(concurrent_vector &rhs);
+};
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::init() {
+    for (size_type k = 0; k < max_segments; ++k) {
+        segments[k].store(nullptr, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::release() {
+    clear();
+    for (size_type k = 0; k < max_segments; ++k) {
+        pointer p = segments[k].load(std::memory_order_relaxed);
+        if (p != nullptr) {
+            allocator_type::deallocate(p, segment_alloc_size(k));
+            segments[k].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::pointer
+concurrent_vector<T, Alloc>::ensure_segment(size_type k) {
+    pointer p = segments[k].load(std::memory_order_acquire);
+    if (p != nullptr) return p;
+    pointer fresh = allocator_type::allocate(segment_alloc_size(k));
+    flag_type *flags = segment_flags(fresh, k);
+    for (size_type i = 0; i < segment_size(k); ++i) {
+        ::new (static_cast<void *>(flags + i)) flag_type(0);
+    }
+    if (segments[k].compare_exchange_strong(p, fresh,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+        return fresh;
+    }
+    // 其他线程先装好了这一段
+    allocator_type::deallocate(fresh, segment_alloc_size(k));
+    return p;
+}
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::ensure_range(size_type first,
+                                               size_type last) {
+    if (first == last) return;
+    const size_type k_last = segment_index(last - 1);
+    for (size_type k = segment_index(first); k <= k_last; ++k) {
+        ensure_segment(k);
+    }
+}
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::reserve_slots(size_type n) {
+    size_type first = count.load(std::memory_order_relaxed);
+    do {
+        MYSTL_LENGTH_ERROR_IF(n > max_size() - first,
+                              "concurrent_vector<T>'s size too big");
+    } while (!count.compare_exchange_weak(first, first + n,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+    return first;
+}
+
+// 段分配或元素构造抛出异常时，占用的下标保持未就绪
+template <typename T, typename Alloc>
+template <typename... Args>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::emplace_back(Args &&...args) {
+    const size_type n = reserve_slots(1);
+    const size_type k = segment_index(n);
+    pointer segment = ensure_segment(k);
+    allocator_type::construct(segment + segment_offset(n),
+                              mystl::forward<Args>(args)...);
+    segment_flags(segment, k)[segment_offset(n)].store(
+        1, std::memory_order_release);
+    return n;
+}
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::grow_by(size_type n, const value_type &value) {
+    const size_type first = reserve_slots(n);
+    ensure_range(first, first + n);
+    for (size_type i = first; i < first + n; ++i) {
+        allocator_type::construct(&(*this)[i], value);
+        ready_flag(i).store(1, std::memory_order_release);
+    }
+    return first;
+}
+
+// 析构所有元素，段内存保留以便复用
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::clear() {
+    const size_type n = count.load(std::memory_order_relaxed);
+    for (size_type k = 0; k < max_segments; ++k) {
+        const size_type seg_first = segment_size(k) - first_segment_size;
+        if (seg_first >= n) break;
+        pointer p = segments[k].load(std::memory_order_relaxed);
+        // 段分配失败时整段都没有元素
+        if (p == nullptr) continue;
+        const size_type seg_n = n - seg_first < segment_size(k)
+                                    ? n - seg_first
+                                    : segment_size(k);
+        flag_type *flags = segment_flags(p, k);
+        for (size_type i = 0; i < seg_n; ++i) {
+            if (flags[i].load(std::memory_order_relaxed) != 0) {
+                mystl::destroy(p + i);
+                flags[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    count.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::swap(concurrent_vector &rhs) {
+    for (size_type k = 0; k < max_segments; ++k) {
+        pointer p = segments[k].load(std::memory_order_relaxed);
+        segments[k].store(rhs.segments[k].load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+        rhs.segments[k].store(p, std::memory_order_relaxed);
+    }
+    const size_type n = count.load(std::memory_order_relaxed);
+    count.store(rhs.count.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    rhs.count.store(n, std::memory_order_relaxed);
+}
+}  // namespace mystl
@@ -1,12 +1,22 @@
 #pragma once
 
 #include <initializer_list>
+#include <type_traits>
 
+#include "algobase.h"
 #include "deque_iterator.h"
 #include "uninitialized.h"
 
 namespace mystl {
+// BufSize为每个缓冲区的元素个数，0表示按元素大小取默认值(见deque_buf_size)
+template <typename T, size_t BufSize = 0>
+class deque;
+
+// 每个缓冲区的元素个数取2的幂，随机访问和迭代器运算不需要除法
 template <typename T>
+using pow2_deque = deque<T, deque_pow2_buf_size(sizeof(T))>;
+
+template <typename T, size_t BufSize>
 class deque {
    public:
     // 数据类型
@@ -21,8 +31,8 @@ class deque {
     using const_reference = const T &;
 
     // 迭代器类型
-    using iterator = deque_iterator<T>;
-    using const_iterator = const deque_iterator<T>;
+    using iterator = deque_iterator<T, BufSize>;
+    using const_iterator = const deque_iterator<T, BufSize>;
 
     using reverse_iterator = mystl::reverse_iterator<iterator>;
     using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
@@ -31,6 +41,9 @@ class deque {
     using map_pointer = pointer *;
     using map_size_type = size_type;
 
+    // 缓存的空闲缓冲区个数上限
+    static constexpr size_type max_spare_nodes = 4;
+
    protected:
     // value,map分配器
     using data_alloc = mystl::simple_alloc<value_type>;
@@ -42,14 +55,20 @@ class deque {
     map_pointer map;
     map_size_type map_size;
 
+    // 首尾释放的缓冲区先放在这里，下次扩展时直接取用，
+    // 在缓冲区边界来回进出的队列因此不再反复申请和释放内存
+    pointer spare_nodes[max_spare_nodes];
+    size_type spare_count = 0;
+
     // 辅助函数
     // 根据默认大小和T的大小，计算map的大小
-    static size_type get_map_size();
+    static constexpr size_type get_map_size();
     static size_type get_initial_map_size();
 
     // 分配，销毁单个map
     pointer allocate_node();
     void deallocate_node(pointer ptr);
+    void release_spare_nodes();
 
     // 根据元素个数创建和销毁map数组和每个map，并分配空间
     void allocate_map(size_type num_elements);
@@ -72,11 +91,28 @@ class deque {
 
     // 插入，复制，填充
     template <typename InputIterator>
-    void copy_init(InputIterator first, InputIterator last);
-
+    void copy_init(InputIterator first, InputIterator last,
+                   input_iterator_tag);
+    template <typename ForwardIterator>
+    void copy_init(ForwardIterator first, ForwardIterator last,
+                   forward_iterator_tag);
+
+    // 中间插入，都只移动position前后较短的一侧
+    template <typename... Args>
+    iterator emplace_aux(iterator position, Args &&...args);
     void insert_aux(iterator position, size_type n, const value_type &value);
+    template <typename ForwardIterator>
+    void insert_aux(iterator position, ForwardIterator first,
+                    ForwardIterator last, size_type n);
     void fill_init(size_type n, const value_type &value);
 
+    template <typename InputIterator>
+    void range_insert(iterator position, InputIterator first,
+                      InputIterator last, input_iterator_tag);
+    template <typename ForwardIterator>
+    void range_insert(iterator position, ForwardIterator first,
+                      ForwardIterator last, forward_iterator_tag);
+
    public:
     // 参数构造函数
     deque();
@@ -91,12 +127,15 @@ class deque {
     //  deque(size_type n);
     //  deque(size_type n, const value_type &value);
     deque(const deque &rhs);
+    deque(deque &&rhs);
 
     // 初始化列表
     deque(std::initializer_list<value_type> il);
 
-    // 迭代器构造函数
-    template <typename InputIterator>
+    // 迭代器构造函数，整数参数交给(n, value)版本
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
     deque(InputIterator first, InputIterator last);
 
     // 析构函数
@@ -104,6 +143,7 @@ class deque {
 
     // 赋值函数
     deque &operator=(const deque &rhs);
+    deque &operator=(deque &&rhs) noexcept;
 
     // 迭代器相关接口
     iterator begin();
@@ -137,24 +177,37 @@ class deque {
     size_type size() const;
     size_type max_size() const;
     bool empty() const;
+    // 释放缓存的空闲缓冲区
+    void shrink_to_fit();
 
     // 修改容器接口
     void swap(deque &rhs);
 
     // 插入删除接口
-    void insert(iterator position);
-    void insert(iterator position, const value_type &value);
+    template <typename... Args>
+    iterator emplace(iterator position, Args &&...args);
+    iterator insert(iterator position);
+    iterator insert(iterator position, const value_type &value);
+    iterator insert(iterator position, value_type &&value);
     void insert(iterator position, size_type n, const value_type &value);
 
-    template <typename InputIterator>
+    template <typename InputIterator,
+              typename = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
     void insert(iterator position, InputIterator first, InputIterator last);
 
-    void erase(iterator position);
-    void erase(iterator first, iterator last);
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last);
     void clear();
 
+    template <typename... Args>
+    void emplace_front(Args &&...args);
+    template <typename... Args>
+    void emplace_back(Args &&...args);
     void push_front(const value_type &value);
+    void push_front(value_type &&value);
     void push_back(const value_type &value);
+    void push_back(value_type &&value);
     void pop_front();
     void pop_back();
 
@@ -172,39 +225,53 @@ class deque {
 };
 
 // 辅助函数
-template <typename T>
-typename deque<T>::size_type deque<T>::get_map_size() {
-    return deque_buf_size(0, sizeof(T));
+template <typename T, size_t BufSize>
+constexpr typename deque<T, BufSize>::size_type
+deque<T, BufSize>::get_map_size() {
+    return iterator::buffer_size();
 }
 
-template <typename T>
-typename deque<T>::size_type deque<T>::get_initial_map_size() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::size_type
+deque<T, BufSize>::get_initial_map_size() {
     return 8;
 }
 
-template <typename T>
-typename deque<T>::pointer deque<T>::allocate_node() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::pointer deque<T, BufSize>::allocate_node() {
+    if (spare_count != 0) {
+        return spare_nodes[--spare_count];
+    }
     return data_alloc::allocate(get_map_size());
 }
 
-template <typename T>
-void deque<T>::deallocate_node(deque<T>::pointer ptr) {
-    data_alloc::deallocate(ptr);
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::deallocate_node(pointer ptr) {
+    if (spare_count < max_spare_nodes) {
+        spare_nodes[spare_count++] = ptr;
+    } else {
+        data_alloc::deallocate(ptr, get_map_size());
+    }
 }
 
-template <typename T>
-void deque<T>::allocate_map(deque<T>::size_type num_elements) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::release_spare_nodes() {
+    while (spare_count != 0) {
+        data_alloc::deallocate(spare_nodes[--spare_count], get_map_size());
+    }
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::allocate_map(size_type num_elements) {
     // 确定map数组的大小
-    deque<T>::size_type new_map_size = num_elements / get_map_size() + 1;
-    // if (num_elements % get_map_size() != 0)
-    //     ++new_map_size;
+    size_type new_map_size = num_elements / get_map_size() + 1;
 
     map_size = std::max(new_map_size, get_initial_map_size() + 2);
     map = map_alloc::allocate(map_size);
 
-    deque<T>::map_pointer new_start = map + (map_size - new_map_size) / 2;
-    deque<T>::map_pointer new_finish = new_start + new_map_size - 1;
-    deque<T>::map_pointer cur;
+    map_pointer new_start = map + (map_size - new_map_size) / 2;
+    map_pointer new_finish = new_start + new_map_size - 1;
+    map_pointer cur;
     try {
         for (cur = new_start; cur <= new_finish; ++cur) *cur = allocate_node();
     } catch (const std::exception &e) {
@@ -212,8 +279,10 @@ void deque<T>::allocate_map(deque<T>::size_type num_elements) {
             --cur;
             deallocate_node(*cur);
         }
-        deque<T>::map_alloc::deallocate(map, map_size);
-        std::cout << e.what() << std::endl;
+        release_spare_nodes();
+        map_alloc::deallocate(map, map_size);
+        std::cerr << e.what() << '\n';
+        throw;
     }
 
     start.set_node(new_start);
@@ -222,75 +291,73 @@ void deque<T>::allocate_map(deque<T>::size_type num_elements) {
     finish.cur = finish.first + num_elements % get_map_size();
 }
 
-template <typename T>
-void deque<T>::deallocate_map() {
-    deque<T>::map_pointer cur;
-    for (cur = start.node; cur <= finish.node; ++cur) deallocate_node(*cur);
-    deque<T>::map_alloc::deallocate(map, map_size);
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::deallocate_map() {
+    for (map_pointer cur = start.node; cur <= finish.node; ++cur) {
+        deallocate_node(*cur);
+    }
+    release_spare_nodes();
+    map_alloc::deallocate(map, map_size);
 }
 
-template <typename T>
-void deque<T>::reallocate_map(deque<T>::size_type added_node_size,
-                              bool added_front) {
-    deque<T>::size_type required_map_size =
-        finish.node - start.node + 1 + added_node_size;
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::reallocate_map(size_type added_node_size,
+                                       bool added_front) {
+    size_type old_node_size = finish.node - start.node + 1;
+    size_type required_map_size = old_node_size + added_node_size;
 
-    deque<T>::map_pointer new_start;
+    map_pointer new_start;
     if (map_size > 2 * required_map_size) {
         new_start = map + (map_size - required_map_size) / 2 +
                     (added_front ? added_node_size : 0);
         if (new_start < start.node)
-            std::copy(start.node, finish.node + 1, new_start);
+            mystl::copy(start.node, finish.node + 1, new_start);
         else
-            std::copy_backward(start.node, finish.node + 1,
-                               new_start + required_map_size);
+            mystl::copy_backward(start.node, finish.node + 1,
+                               new_start + old_node_size);
     } else {
-        deque<T>::size_type new_map_size =
+        size_type new_map_size =
             map_size + std::max(map_size, added_node_size) + 2;
-        deque<T>::map_pointer new_map =
-            deque<T>::map_alloc::allocate(new_map_size);
+        map_pointer new_map = map_alloc::allocate(new_map_size);
         new_start = new_map + (new_map_size - required_map_size) / 2 +
                     (added_front ? added_node_size : 0);
-        if (new_start < start.node)
-            std::copy(start.node, finish.node + 1, new_start);
-        else
-            std::copy_backward(start.node, finish.node + 1,
-                               new_start + required_map_size);
-        deque<T>::map_alloc::deallocate(map);
+        mystl::copy(start.node, finish.node + 1, new_start);
+        map_alloc::deallocate(map, map_size);
         map = new_map;
         map_size = new_map_size;
     }
     start.set_node(new_start);
-    finish.set_node(new_start + required_map_size - 1);
+    finish.set_node(new_start + old_node_size - 1);
 }
 
-template <typename T>
-void deque<T>::expand_map_front(deque<T>::size_type n) {
-    if (n > start.node - map) {
+// 保证start.node之前至少还有n个map槽位
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::expand_map_front(size_type n) {
+    if (n > static_cast<size_type>(start.node - map)) {
         reallocate_map(n, true);
     }
 }
 
-template <typename T>
-void deque<T>::expand_map_back(deque<T>::size_type n) {
+// 保证finish.node之后至少还有n个map槽位
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::expand_map_back(size_type n) {
     if (n + 1 > map_size - (finish.node - map)) {
         reallocate_map(n, false);
     }
 }
 
-template <typename T>
-typename deque<T>::iterator deque<T>::expand_front(deque<T>::size_type n) {
-    deque<T>::size_type left = start.cur - start.first;
+// 在start之前准备好n个元素的空间，返回新的起点，start本身不变
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::expand_front(
+    size_type n) {
+    size_type left = start.cur - start.first;
     if (left < n) {
-        deque<T>::size_type required_element = n - left;
-        deque<T>::size_type required_node =
-            (required_element - 1) / get_map_size();
-        if (required_element % get_map_size() != 0) ++required_node;
-
+        size_type required_node = (n - left + get_map_size() - 1) /
+                                  get_map_size();
         expand_map_front(required_node);
-        deque<T>::size_type i;
+        size_type i;
         try {
-            for (i = 1; i < required_node; ++i) {
+            for (i = 1; i <= required_node; ++i) {
                 *(start.node - i) = allocate_node();
             }
         } catch (const std::exception &e) {
@@ -298,124 +365,297 @@ typename deque<T>::iterator deque<T>::expand_front(deque<T>::size_type n) {
                 deallocate_node(*(start.node - i));
             }
             std::cerr << e.what() << '\n';
+            throw;
         }
     }
-    return start - deque<T>::difference_type(n);
+    return start - difference_type(n);
 }
 
-template <typename T>
-typename deque<T>::iterator deque<T>::expand_back(deque<T>::size_type n) {
-    deque<T>::size_type required_element = finish.last - finish.cur;
-    deque<T>::size_type required_node = (required_element - 1) / get_map_size();
-    if (required_element % get_map_size() != 0) ++required_node;
-
-    expand_map_back(required_node);
-    deque<T>::size_type i;
-    try {
-        for (i = 1; i <= required_node; ++i) {
-            *(finish.node + i) = allocate_node();
-        }
-    } catch (const std::exception &e) {
-        while (--i >= 1) {
-            deallocate_node(*(finish.node + i));
+// 在finish之后准备好n个元素的空间，返回新的终点，finish本身不变
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::expand_back(
+    size_type n) {
+    size_type left = finish.last - finish.cur - 1;
+    if (left < n) {
+        size_type required_node = (n - left + get_map_size() - 1) /
+                                  get_map_size();
+        expand_map_back(required_node);
+        size_type i;
+        try {
+            for (i = 1; i <= required_node; ++i) {
+                *(finish.node + i) = allocate_node();
+            }
+        } catch (const std::exception &e) {
+            while (--i >= 1) {
+                deallocate_node(*(finish.node + i));
+            }
+            std::cerr << e.what() << '\n';
+            throw;
         }
-        std::cerr << e.what() << '\n';
     }
-    return finish + deque<T>::difference_type(n);
+    return finish + difference_type(n);
 }
 
-template <typename T>
-void deque<T>::destroy_map_front(deque<T>::iterator before_start) {
-    for (deque<T>::map_pointer i = before_start; i < start.node; ++i) {
+// 释放expand_front多准备的缓冲区
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::destroy_map_front(iterator before_start) {
+    for (map_pointer i = before_start.node; i < start.node; ++i) {
         deallocate_node(*i);
     }
 }
 
-template <typename T>
-void deque<T>::destroy_map_back(deque<T>::iterator after_finish) {
-    for (deque<T>::map_pointer i = after_finish; i > finish.node; --i) {
+// 释放expand_back多准备的缓冲区
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::destroy_map_back(iterator after_finish) {
+    for (map_pointer i = after_finish.node; i > finish.node; --i) {
         deallocate_node(*i);
     }
 }
 
-template <typename T>
+template <typename T, size_t BufSize>
 template <typename InputIterator>
-void deque<T>::copy_init(InputIterator first, InputIterator last) {
+void deque<T, BufSize>::copy_init(InputIterator first, InputIterator last,
+                                  input_iterator_tag) {
     allocate_map(0);
-    for (; first != last; ++first) {
-        push_back(*first);
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (const std::exception &e) {
+        clear();
+        deallocate_map();
+        throw;
     }
 }
 
-template <typename T>
-void deque<T>::insert_aux(deque<T>::iterator position, deque<T>::size_type n,
-                          const deque<T>::value_type &value) {
-    deque<T>::difference_type offset = position - start;
-    deque<T>::size_type elems_before = offset;
-    if (elems_before < deque<T>::size() / 2) {
-        deque<T>::iterator new_start = expand_front(elems_before);
-        deque<T>::iterator old_start = start;
+// 长度已知时一次分配好map和所有缓冲区
+template <typename T, size_t BufSize>
+template <typename ForwardIterator>
+void deque<T, BufSize>::copy_init(ForwardIterator first, ForwardIterator last,
+                                  forward_iterator_tag) {
+    allocate_map(mystl::distance(first, last));
+    try {
+        mystl::uninitialized_copy(first, last, start);
+    } catch (const std::exception &e) {
+        deallocate_map();
+        throw;
+    }
+}
+
+// 先构造出新元素，再把较短一侧整体挪动一格，空出的位置移动赋值
+template <typename T, size_t BufSize>
+template <typename... Args>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::emplace_aux(
+    iterator position, Args &&...args) {
+    value_type value(mystl::forward<Args>(args)...);
+    const difference_type index = position - start;
+    if (size_type(index) < size() / 2) {
+        emplace_front(mystl::move(front()));
+        position = start + index;
+        mystl::move(start + 2, position + 1, start + 1);
+    } else {
+        emplace_back(mystl::move(back()));
+        position = start + index;
+        mystl::move_backward(position, finish - 2, finish - 1);
+    }
+    *position = mystl::move(value);
+    return position;
+}
+
+// 在position处插入n个value，只移动较短的一侧。
+// 先在首尾构造新位置上的元素，构造失败时归还新申请的缓冲区，
+// 之后的移动赋值和填充只提供基本的异常保证
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::insert_aux(iterator position, size_type n,
+                                   const value_type &value) {
+    const difference_type elems_before = position - start;
+    const difference_type len = size();
+    const difference_type count = n;
+    value_type value_copy = value;  // value可能就是容器中的元素
+    if (elems_before < len / 2) {
+        iterator new_start = expand_front(n);
+        iterator old_start = start;
         position = start + elems_before;
-        try {
-            uninitialized_copy(old_start, position, new_start);
-            uninitialized_fill(position - n, position, value);
+        if (elems_before >= count) {
+            iterator start_n = start + count;
+            try {
+                mystl::uninitialized_move(start, start_n, new_start);
+            } catch (const std::exception &e) {
+                destroy_map_front(new_start);
+                throw;
+            }
             start = new_start;
-        } catch (const std::exception &e) {
-            destroy_map_front(new_start);
-            std::cerr << e.what() << '\n';
+            mystl::move(start_n, position, old_start);
+            mystl::fill(position - count, position, value_copy);
+        } else {
+            iterator mid;
+            try {
+                mid = mystl::uninitialized_move(start, position, new_start);
+                try {
+                    mystl::uninitialized_fill(mid, start, value_copy);
+                } catch (const std::exception &e) {
+                    mystl::destroy(new_start, mid);
+                    throw;
+                }
+            } catch (const std::exception &e) {
+                destroy_map_front(new_start);
+                throw;
+            }
+            start = new_start;
+            mystl::fill(old_start, position, value_copy);
         }
     } else {
-        deque<T>::iterator new_finish = expand_back(n);
-        deque<T>::iterator old_finish = finish;
+        iterator new_finish = expand_back(n);
+        iterator old_finish = finish;
+        const difference_type elems_after = len - elems_before;
+        position = finish - elems_after;
+        if (elems_after > count) {
+            iterator finish_n = finish - count;
+            try {
+                mystl::uninitialized_move(finish_n, finish, finish);
+            } catch (const std::exception &e) {
+                destroy_map_back(new_finish);
+                throw;
+            }
+            finish = new_finish;
+            mystl::move_backward(position, finish_n, old_finish);
+            mystl::fill(position, position + count, value_copy);
+        } else {
+            iterator mid = position + count;
+            try {
+                mystl::uninitialized_fill(finish, mid, value_copy);
+                try {
+                    mystl::uninitialized_move(position, finish, mid);
+                } catch (const std::exception &e) {
+                    mystl::destroy(finish, mid);
+                    throw;
+                }
+            } catch (const std::exception &e) {
+                destroy_map_back(new_finish);
+                throw;
+            }
+            finish = new_finish;
+            mystl::fill(position, old_finish, value_copy);
+        }
+    }
+}
+
+// 在position处插入[first, last)的n个元素，做法同上
+template <typename T, size_t BufSize>
+template <typename ForwardIterator>
+void deque<T, BufSize>::insert_aux(iterator position, ForwardIterator first,
+                                   ForwardIterator last, size_type n) {
+    const difference_type elems_before = position - start;
+    const difference_type len = size();
+    const difference_type count = n;
+    if (elems_before < len / 2) {
+        iterator new_start = expand_front(n);
+        iterator old_start = start;
         position = start + elems_before;
-        deque<T>::size_type elems_after = deque<T>::size() - elems_before;
-        try {
-            uninitialized_copy(position, position + elems_after, position + n);
-            uninitialized_fill(position, position + n, value);
+        if (elems_before >= count) {
+            iterator start_n = start + count;
+            try {
+                mystl::uninitialized_move(start, start_n, new_start);
+            } catch (const std::exception &e) {
+                destroy_map_front(new_start);
+                throw;
+            }
+            start = new_start;
+            mystl::move(start_n, position, old_start);
+            mystl::copy(first, last, position - count);
+        } else {
+            ForwardIterator mid = first;
+            mystl::advance(mid, count - elems_before);
+            try {
+                iterator constructed =
+                    mystl::uninitialized_move(start, position, new_start);
+                try {
+                    mystl::uninitialized_copy(first, mid, constructed);
+                } catch (const std::exception &e) {
+                    mystl::destroy(new_start, constructed);
+                    throw;
+                }
+            } catch (const std::exception &e) {
+                destroy_map_front(new_start);
+                throw;
+            }
+            start = new_start;
+            mystl::copy(mid, last, old_start);
+        }
+    } else {
+        iterator new_finish = expand_back(n);
+        iterator old_finish = finish;
+        const difference_type elems_after = len - elems_before;
+        position = finish - elems_after;
+        if (elems_after > count) {
+            iterator finish_n = finish - count;
+            try {
+                mystl::uninitialized_move(finish_n, finish, finish);
+            } catch (const std::exception &e) {
+                destroy_map_back(new_finish);
+                throw;
+            }
             finish = new_finish;
-        } catch (const std::exception &e) {
-            destroy_map_back(new_finish);
-            std::cerr << e.what() << '\n';
+            mystl::move_backward(position, finish_n, old_finish);
+            mystl::copy(first, last, position);
+        } else {
+            ForwardIterator mid = first;
+            mystl::advance(mid, elems_after);
+            try {
+                iterator constructed =
+                    mystl::uninitialized_copy(mid, last, finish);
+                try {
+                    mystl::uninitialized_move(position, finish, constructed);
+                } catch (const std::exception &e) {
+                    mystl::destroy(finish, constructed);
+                    throw;
+                }
+            } catch (const std::exception &e) {
+                destroy_map_back(new_finish);
+                throw;
+            }
+            finish = new_finish;
+            mystl::copy(first, mid, position);
         }
     }
 }
 
-template <typename T>
-void deque<T>::fill_init(deque<T>::size_type n,
-                         const deque<T>::value_type &value) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::fill_init(size_type n, const value_type &value) {
     allocate_map(n);
-    deque<T>::map_pointer cur;
+    map_pointer cur = start.node;
     try {
-        for (cur = start.node; cur < finish.node; ++cur) {
-            uninitialized_fill(*cur, *cur + get_map_size(), value);
+        for (; cur < finish.node; ++cur) {
+            mystl::uninitialized_fill(*cur, *cur + get_map_size(), value);
         }
-        uninitialized_fill(finish.first, finish.cur, value);
+        mystl::uninitialized_fill(finish.first, finish.cur, value);
     } catch (const std::exception &e) {
         while (--cur >= start.node) {
-            destroy(*cur, *cur + get_map_size());
+            mystl::destroy(*cur, *cur + get_map_size());
         }
         deallocate_map();
 
         std::cerr << e.what() << '\n';
+        throw;
     }
 }
 
 // 公有接口
 // 参数构造函数
-template <typename T>
-deque<T>::deque() {
+template <typename T, size_t BufSize>
+deque<T, BufSize>::deque() {
     allocate_map(0);
 }
 
-template <typename T>
+template <typename T, size_t BufSize>
 template <typename T1>
-deque<T>::deque(const T1 n) {
-    fill_init(n, deque<T>::value_type());
+deque<T, BufSize>::deque(const T1 n) {
+    fill_init(n, value_type());
 }
 
-template <typename T>
+template <typename T, size_t BufSize>
 template <typename T1, typename T2>
-deque<T>::deque(const T1 n, const T2 &value) {
+deque<T, BufSize>::deque(const T1 n, const T2 &value) {
     fill_init(n, value);
 }
 
@@ -432,314 +672,452 @@ deque<T>::deque(const T1 n, const T2 &value) {
 //     fill_init(n, value);
 // }
 
-template <typename T>
-deque<T>::deque(const deque<T> &rhs) {
-    copy_init(rhs.begin(), rhs.end());
+template <typename T, size_t BufSize>
+deque<T, BufSize>::deque(const deque &rhs) {
+    copy_init(rhs.begin(), rhs.end(), random_access_iterator_tag());
+}
+
+// 被移动的deque留下一个空的map，仍然可以继续使用
+template <typename T, size_t BufSize>
+deque<T, BufSize>::deque(deque &&rhs) {
+    allocate_map(0);
+    swap(rhs);
 }
 
 // 初始化列表
-template <typename T>
-deque<T>::deque(std::initializer_list<value_type> il) {
-    copy_init(il.begin(), il.end());
+template <typename T, size_t BufSize>
+deque<T, BufSize>::deque(std::initializer_list<value_type> il) {
+    copy_init(il.begin(), il.end(), random_access_iterator_tag());
 }
 
 // 迭代器构造函数
-template <typename T>
-template <typename InputIterator>
-deque<T>::deque(InputIterator first, InputIterator last) {
-    copy_init(first, last);
+template <typename T, size_t BufSize>
+template <typename InputIterator, typename>
+deque<T, BufSize>::deque(InputIterator first, InputIterator last) {
+    copy_init(first, last, mystl::iterator_category(first));
 }
 
 // 析构函数
-template <typename T>
-deque<T>::~deque() {
-    destroy(start, finish);
+template <typename T, size_t BufSize>
+deque<T, BufSize>::~deque() {
+    mystl::destroy(start, finish);
     deallocate_map();
 }
 
 // 赋值函数
-template <typename T>
-deque<T> &deque<T>::operator=(const deque<T> &rhs) {
+template <typename T, size_t BufSize>
+deque<T, BufSize> &deque<T, BufSize>::operator=(const deque &rhs) {
     if (this != &rhs) {
         size_t len = size();
         if (len >= rhs.size()) {
-            erase(std::copy(rhs.begin(), rhs.end(), begin()), end());
+            erase(mystl::copy(rhs.begin(), rhs.end(), begin()), end());
         } else {
-            deque<T>::const_iterator mid =
-                rhs.begin() + deque<T>::difference_type(len);
-            std::copy(rhs.begin(), rhs.end(), begin());
+            const_iterator mid = rhs.begin() + difference_type(len);
+            mystl::copy(rhs.begin(), mid, begin());
             insert(end(), mid, rhs.end());
         }
     }
     return *this;
 }
 
+template <typename T, size_t BufSize>
+deque<T, BufSize> &deque<T, BufSize>::operator=(deque &&rhs) noexcept {
+    if (this != &rhs) {
+        clear();
+        swap(rhs);
+    }
+    return *this;
+}
+
 // 迭代器相关接口
-template <typename T>
-typename deque<T>::iterator deque<T>::begin() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::begin() {
     return start;
 }
 
-template <typename T>
-typename deque<T>::const_iterator deque<T>::begin() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_iterator deque<T, BufSize>::begin() const {
     return start;
 }
 
-template <typename T>
-typename deque<T>::const_iterator deque<T>::cbegin() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_iterator deque<T, BufSize>::cbegin() const {
     return start;
 }
 
-template <typename T>
-typename deque<T>::iterator deque<T>::end() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::end() {
     return finish;
 }
 
-template <typename T>
-typename deque<T>::const_iterator deque<T>::end() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_iterator deque<T, BufSize>::end() const {
     return finish;
 }
 
-template <typename T>
-typename deque<T>::const_iterator deque<T>::cend() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_iterator deque<T, BufSize>::cend() const {
     return finish;
 }
 
 // 反向迭代器
-template <typename T>
-typename deque<T>::reverse_iterator deque<T>::rbegin() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reverse_iterator deque<T, BufSize>::rbegin() {
     return reverse_iterator(finish);
 }
 
-template <typename T>
-typename deque<T>::const_reverse_iterator deque<T>::rbegin() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reverse_iterator deque<T, BufSize>::rbegin()
+    const {
     return const_reverse_iterator(finish);
 }
 
-template <typename T>
-typename deque<T>::const_reverse_iterator deque<T>::crbegin() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reverse_iterator
+deque<T, BufSize>::crbegin() const {
     return const_reverse_iterator(finish);
 }
 
-template <typename T>
-typename deque<T>::reverse_iterator deque<T>::rend() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reverse_iterator deque<T, BufSize>::rend() {
     return reverse_iterator(start);
 }
 
-template <typename T>
-typename deque<T>::const_reverse_iterator deque<T>::rend() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reverse_iterator deque<T, BufSize>::rend()
+    const {
     return const_reverse_iterator(start);
 }
 
-template <typename T>
-typename deque<T>::const_reverse_iterator deque<T>::crend() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reverse_iterator deque<T, BufSize>::crend()
+    const {
     return const_reverse_iterator(start);
 }
 
 // 访问取值接口
-template <typename T>
-typename deque<T>::reference deque<T>::operator[](deque<T>::size_type n) {
-    return start[difference_type(n)];
+// 偏移非负，直接按无符号数求块号和块内位置，不构造临时迭代器；
+// 块大小是2的幂时除法和取模会编译成移位和掩码
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reference deque<T, BufSize>::operator[](
+    size_type n) {
+    const size_type offset = n + (start.cur - start.first);
+    return start.node[offset / get_map_size()][offset % get_map_size()];
 }
 
-template <typename T>
-typename deque<T>::const_reference deque<T>::operator[](
-    deque<T>::size_type n) const {
-    return start[difference_type(n)];
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reference deque<T, BufSize>::operator[](
+    size_type n) const {
+    const size_type offset = n + (start.cur - start.first);
+    return start.node[offset / get_map_size()][offset % get_map_size()];
 }
 
-template <typename T>
-typename deque<T>::reference deque<T>::at(deque<T>::size_type n) {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reference deque<T, BufSize>::at(size_type n) {
     return *(begin() + n);
 }
 
-template <typename T>
-typename deque<T>::const_reference deque<T>::at(deque<T>::size_type n) const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reference deque<T, BufSize>::at(
+    size_type n) const {
     return *(cbegin() + n);
 }
 
 // 访问首尾
-template <typename T>
-typename deque<T>::reference deque<T>::front() {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reference deque<T, BufSize>::front() {
     return *begin();
 }
 
-template <typename T>
-typename deque<T>::const_reference deque<T>::front() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reference deque<T, BufSize>::front() const {
     return *cbegin();
 }
 
-template <typename T>
-typename deque<T>::reference deque<T>::back() {
-    deque<T>::iterator tmp = finish;
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::reference deque<T, BufSize>::back() {
+    iterator tmp = finish;
     --tmp;
     return *tmp;
 }
 
-template <typename T>
-typename deque<T>::const_reference deque<T>::back() const {
-    deque<T>::const_iterator tmp = finish;
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::const_reference deque<T, BufSize>::back() const {
+    iterator tmp = finish;
     --tmp;
     return *tmp;
 }
 
 // 容器相关接口
-template <typename T>
-typename deque<T>::size_type deque<T>::size() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::size_type deque<T, BufSize>::size() const {
     return finish - start;
 }
 
-template <typename T>
-typename deque<T>::size_type deque<T>::max_size() const {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::size_type deque<T, BufSize>::max_size() const {
     return static_cast<size_type>(-1) / sizeof(T);
 }
 
-template <typename T>
-bool deque<T>::empty() const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::empty() const {
     return start == finish;
 }
 
-template <typename T>
-void deque<T>::swap(deque<T> &rhs) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::shrink_to_fit() {
+    release_spare_nodes();
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::swap(deque &rhs) {
     std::swap(start, rhs.start);
     std::swap(finish, rhs.finish);
     std::swap(map, rhs.map);
     std::swap(map_size, rhs.map_size);
+    std::swap(spare_nodes, rhs.spare_nodes);
+    std::swap(spare_count, rhs.spare_count);
 }
 
-template <typename T>
-void deque<T>::insert(deque<T>::iterator position) {
-    insert(position, 1, T());
+template <typename T, size_t BufSize>
+template <typename... Args>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::emplace(
+    iterator position, Args &&...args) {
+    if (position.cur == start.cur) {
+        emplace_front(mystl::forward<Args>(args)...);
+        return start;
+    } else if (position.cur == finish.cur) {
+        emplace_back(mystl::forward<Args>(args)...);
+        return finish - 1;
+    }
+    return emplace_aux(position, mystl::forward<Args>(args)...);
 }
 
-template <typename T>
-void deque<T>::insert(deque<T>::iterator position,
-                      const deque<T>::value_type &value) {
-    insert(position, 1, value);  // 委托给其他接口，性能不好
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert(
+    iterator position) {
+    return emplace(position);
 }
 
-template <typename T>
-void deque<T>::insert(deque<T>::iterator position, deque<T>::size_type n,
-                      const deque<T>::value_type &value) {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert(
+    iterator position, const value_type &value) {
+    return emplace(position, value);
+}
+
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::insert(
+    iterator position, value_type &&value) {
+    return emplace(position, mystl::move(value));
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::insert(iterator position, size_type n,
+                               const value_type &value) {
+    if (n == 0) {
+        return;
+    }
     if (position.cur == start.cur) {
-        deque<T>::iterator new_start = expand_front(n);
-        uninitialized_fill(new_start, start, value);
+        iterator new_start = expand_front(n);
+        try {
+            mystl::uninitialized_fill(new_start, start, value);
+        } catch (const std::exception &e) {
+            destroy_map_front(new_start);
+            throw;
+        }
         start = new_start;
     } else if (position.cur == finish.cur) {
-        deque<T>::iterator new_finish = expand_back(n);
-        uninitialized_fill(finish, new_finish, value);
+        iterator new_finish = expand_back(n);
+        try {
+            mystl::uninitialized_fill(finish, new_finish, value);
+        } catch (const std::exception &e) {
+            destroy_map_back(new_finish);
+            throw;
+        }
         finish = new_finish;
     } else {
         insert_aux(position, n, value);
     }
-};
+}
 
-template <typename T>
+template <typename T, size_t BufSize>
+template <typename InputIterator, typename>
+void deque<T, BufSize>::insert(iterator position, InputIterator first,
+                               InputIterator last) {
+    range_insert(position, first, last, mystl::iterator_category(first));
+}
+
+// 单遍迭代器长度未知，只能逐个插入
+template <typename T, size_t BufSize>
 template <typename InputIterator>
-void deque<T>::insert(deque<T>::iterator position, InputIterator first,
-                      InputIterator last) {
-    std::copy(first, last, std::inserter(*this, position));  // std实现
+void deque<T, BufSize>::range_insert(iterator position, InputIterator first,
+                                     InputIterator last, input_iterator_tag) {
+    difference_type offset = position - start;
+    for (; first != last; ++first, ++offset) {
+        emplace(start + offset, *first);
+    }
 }
 
-template <typename T>
-void deque<T>::erase(deque<T>::iterator position) {
-    erase(position, position + 1);
+// 先求出长度，map和缓冲区只扩展一次
+template <typename T, size_t BufSize>
+template <typename ForwardIterator>
+void deque<T, BufSize>::range_insert(iterator position, ForwardIterator first,
+                                     ForwardIterator last,
+                                     forward_iterator_tag) {
+    const size_type n = mystl::distance(first, last);
+    if (n == 0) {
+        return;
+    }
+    if (position.cur == start.cur) {
+        iterator new_start = expand_front(n);
+        try {
+            mystl::uninitialized_copy(first, last, new_start);
+        } catch (const std::exception &e) {
+            destroy_map_front(new_start);
+            throw;
+        }
+        start = new_start;
+    } else if (position.cur == finish.cur) {
+        iterator new_finish = expand_back(n);
+        try {
+            mystl::uninitialized_copy(first, last, finish);
+        } catch (const std::exception &e) {
+            destroy_map_back(new_finish);
+            throw;
+        }
+        finish = new_finish;
+    } else {
+        insert_aux(position, first, last, n);
+    }
 }
 
-template <typename T>
-void deque<T>::erase(deque<T>::iterator first, deque<T>::iterator last) {
-    if (first == start && last == finish) {
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::erase(
+    iterator position) {
+    return erase(position, position + 1);
+}
+
+// 把被删除区间前后较短的一侧移动过来补上空位
+template <typename T, size_t BufSize>
+typename deque<T, BufSize>::iterator deque<T, BufSize>::erase(iterator first,
+                                                              iterator last) {
+    if (first == last) {
+        return first;
+    } else if (first == start && last == finish) {
         clear();
+        return finish;
     } else {
-        deque<T>::difference_type n = last - first;
-        deque<T>::difference_type elems_before = first - start;
-        if (elems_before < (size() - n) / 2) {
-            std::copy_backward(start, first, last);
-            deque<T>::iterator new_start = start + n;
-            destroy(start, new_start);
-            for (deque<T>::map_pointer node = start.node; node < new_start.node;
+        difference_type n = last - first;
+        difference_type elems_before = first - start;
+        if (elems_before < difference_type(size() - n) / 2) {
+            mystl::move_backward(start, first, last);
+            iterator new_start = start + n;
+            mystl::destroy(start, new_start);
+            for (map_pointer node = start.node; node < new_start.node;
                  ++node) {
-                data_alloc::deallocate(*node, get_map_size());
+                deallocate_node(*node);
             }
             start = new_start;
         } else {
-            std::copy(last, finish, first);
-            deque<T>::iterator new_finish = finish - n;
-            destroy(new_finish, finish);
-            for (deque<T>::map_pointer node = new_finish.node + 1;
-                 node < finish.node; ++node) {
-                data_alloc::deallocate(*node, get_map_size());
+            mystl::move(last, finish, first);
+            iterator new_finish = finish - n;
+            mystl::destroy(new_finish, finish);
+            for (map_pointer node = new_finish.node + 1; node <= finish.node;
+                 ++node) {
+                deallocate_node(*node);
             }
             finish = new_finish;
         }
+        return start + elems_before;
     }
 }
 
-template <typename T>
-void deque<T>::clear() {
-    for (deque<T>::map_pointer node = start.node + 1; node < finish.node;
-         ++node) {
-        destroy(*node, *node + get_map_size());
-        deallocate(*node,
-                   get_map_size());  // 如果destroy已经释放内存，这里就不需要了
+// 清空后保留start所在的缓冲区
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::clear() {
+    for (map_pointer node = start.node + 1; node < finish.node; ++node) {
+        mystl::destroy(*node, *node + get_map_size());
+        deallocate_node(*node);
     }
     if (start.node != finish.node) {
-        destroy(start.cur, start.last);
-        destroy(finish.first, finish.cur);
-        deallocate(start.first,
-                   get_map_size());  // 如果destroy已经释放内存，这里就不需要了
-        deallocate(finish.first, get_map_size());
+        mystl::destroy(start.cur, start.last);
+        mystl::destroy(finish.first, finish.cur);
+        deallocate_node(finish.first);
     } else {
-        destroy(start.cur, finish.cur);
-        deallocae(start.first,
-                  get_map_size());  // 如果destroy已经释放内存，这里就不需要了
+        mystl::destroy(start.cur, finish.cur);
     }
+    finish = start;
 }
 
-template <typename T>
-void deque<T>::push_front(const deque<T>::value_type &value) {
+template <typename T, size_t BufSize>
+template <typename... Args>
+void deque<T, BufSize>::emplace_front(Args &&...args) {
     if (start.first != start.cur) {
+        mystl::construct(start.cur - 1, mystl::forward<Args>(args)...);
         --start.cur;
-        mystl::construct(start.cur, value);
     } else {
-        expand_front(1);
+        expand_map_front(1);
         *(start.node - 1) = allocate_node();
         try {
-            start.set_node(start.node - 1);
-            start.cur = start.last - 1;
-            mystl::construct(start.cur, value);
+            mystl::construct(*(start.node - 1) + get_map_size() - 1,
+                             mystl::forward<Args>(args)...);
         } catch (const std::exception &e) {
             deallocate_node(*(start.node - 1));
             std::cerr << e.what() << '\n';
+            throw;
         }
+        start.set_node(start.node - 1);
+        start.cur = start.last - 1;
     }
 }
 
-template <typename T>
-void deque<T>::push_back(const deque<T>::value_type &value) {
+template <typename T, size_t BufSize>
+template <typename... Args>
+void deque<T, BufSize>::emplace_back(Args &&...args) {
     if (finish.cur != finish.last - 1) {
-        mystl::construct(finish.cur, value);
+        mystl::construct(finish.cur, mystl::forward<Args>(args)...);
         ++finish.cur;
     } else {
-        expand_back(1);
+        expand_map_back(1);
         *(finish.node + 1) = allocate_node();
         try {
-            mystl::construct(finish.cur, value);
-            finish.set_node(finish.node + 1);
-            finish.cur = finish.first;
+            mystl::construct(finish.cur, mystl::forward<Args>(args)...);
         } catch (const std::exception &e) {
             deallocate_node(*(finish.node + 1));
             std::cerr << e.what() << '\n';
+            throw;
         }
+        finish.set_node(finish.node + 1);
+        finish.cur = finish.first;
     }
 }
 
-template <typename T>
-void deque<T>::pop_front() {
-    if (size() <= 0) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::push_front(const value_type &value) {
+    emplace_front(value);
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::push_front(value_type &&value) {
+    emplace_front(mystl::move(value));
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::push_back(const value_type &value) {
+    emplace_back(value);
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::push_back(value_type &&value) {
+    emplace_back(mystl::move(value));
+}
+
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::pop_front() {
+    if (empty()) {
         return;
     }
-    destroy(start.cur);
+    mystl::destroy(start.cur);
     if (start.cur != start.last - 1) {
         ++start.cur;
     } else {
@@ -749,30 +1127,29 @@ void deque<T>::pop_front() {
     }
 }
 
-template <typename T>
-void deque<T>::pop_back() {
-    if (size() <= 0) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::pop_back() {
+    if (empty()) {
         return;
     }
     if (finish.cur != finish.first) {
         --finish.cur;
-        destroy(finish.cur);
+        mystl::destroy(finish.cur);
     } else {
-        deallocate_node(finish.last);
+        deallocate_node(finish.first);
         finish.set_node(finish.node - 1);
         finish.cur = finish.last - 1;
-        destroy(finish.cur);
+        mystl::destroy(finish.cur);
     }
 }
 
-template <typename T>
-void deque<T>::resize(deque<T>::size_type new_size) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::resize(size_type new_size) {
     resize(new_size, T());
 }
 
-template <typename T>
-void deque<T>::resize(deque<T>::size_type new_size,
-                      const deque<T>::value_type &value) {
+template <typename T, size_t BufSize>
+void deque<T, BufSize>::resize(size_type new_size, const value_type &value) {
     if (new_size < size()) {
         erase(start + new_size, finish);
     } else {
@@ -780,33 +1157,33 @@ void deque<T>::resize(deque<T>::size_type new_size,
     }
 }
 
-template <typename T>
-bool deque<T>::operator==(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator==(const deque &rhs) const {
     return size() == rhs.size() && std::equal(begin(), end(), rhs.begin());
 }
 
-template <typename T>
-bool deque<T>::operator!=(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator!=(const deque &rhs) const {
     return !(*this == rhs);
 }
 
-template <typename T>
-bool deque<T>::operator<(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator<(const deque &rhs) const {
     return std::lexicographical_compare(begin(), end(), rhs.begin(), rhs.end());
 }
 
-template <typename T>
-bool deque<T>::operator<=(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator<=(const deque &rhs) const {
     return (*this == rhs) || (*this < rhs);
 }
 
-template <typename T>
-bool deque<T>::operator>(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator>(const deque &rhs) const {
     return std::lexicographical_compare(rhs.begin(), rhs.end(), begin(), end());
 }
 
-template <typename T>
-bool deque<T>::operator>=(const deque &rhs) const {
+template <typename T, size_t BufSize>
+bool deque<T, BufSize>::operator>=(const deque &rhs) const {
     return (*this == rhs) || (*this > rhs);
 }
 }  // namespace mystl
@@ -8,12 +8,22 @@
 
 namespace mystl {
 // 计算deque的缓冲区大小，默认每个缓冲区为1024/sizeof(T)或者4个
-inline size_t deque_buf_size(size_t n, size_t sz) {
+// n不为0时直接作为每个缓冲区的元素个数
+constexpr size_t deque_buf_size(size_t n, size_t sz) {
     return n != 0 ? n : (sz < 256 ? (1024 / sz) : static_cast<size_t>(4));
 }
 
-// deque的迭代器
-template <typename T>
+constexpr size_t deque_log2(size_t n) {
+    return n <= 1 ? 0 : 1 + deque_log2(n >> 1);
+}
+
+// 不超过默认大小的最大的2的幂，作为BufSize时迭代器运算全部是移位和掩码
+constexpr size_t deque_pow2_buf_size(size_t sz) {
+    return size_t(1) << deque_log2(deque_buf_size(0, sz));
+}
+
+// deque的迭代器，BufSize与deque的同名参数一致
+template <typename T, size_t BufSize = 0>
 struct deque_iterator {
     using iterator_category = random_access_iterator_tag;
     using value_type = T;
@@ -24,8 +34,8 @@ struct deque_iterator {
     using size_type = size_t;
     using map_pointer = T **;
 
-    using iterator = deque_iterator<T>;
-    using const_iterator = const deque_iterator<T>;
+    using iterator = deque_iterator<T, BufSize>;
+    using const_iterator = const deque_iterator<T, BufSize>;
     using self = deque_iterator;
 
     T *cur;
@@ -33,9 +43,19 @@ struct deque_iterator {
     T *last;
     map_pointer node;
 
+    // 每个缓冲区的元素个数是2的幂时，块号和块内偏移用移位和掩码计算
+    static constexpr bool is_pow2_buffer =
+        (deque_buf_size(BufSize, sizeof(T)) &
+         (deque_buf_size(BufSize, sizeof(T)) - 1)) == 0;
+    static constexpr size_t buffer_shift =
+        deque_log2(deque_buf_size(BufSize, sizeof(T)));
+
    public:
     // 缓冲区大小
-    static size_t buffer_size();
+    static constexpr size_t buffer_size();
+
+    // 相对当前缓冲区起点的偏移offset落在第几个缓冲区，向下取整
+    static difference_type node_offset(difference_type offset);
 
     // 更新迭代器的状态
     void set_node(map_pointer new_node);
@@ -73,55 +93,69 @@ struct deque_iterator {
 };
 
 // 缓冲区大小
-template <typename T>
-size_t deque_iterator<T>::buffer_size() {
-    return deque_buf_size(0, sizeof(T));
+template <typename T, size_t BufSize>
+constexpr size_t deque_iterator<T, BufSize>::buffer_size() {
+    return deque_buf_size(BufSize, sizeof(T));
+}
+
+template <typename T, size_t BufSize>
+typename deque_iterator<T, BufSize>::difference_type
+deque_iterator<T, BufSize>::node_offset(difference_type offset) {
+    if (is_pow2_buffer) {
+        // 算术右移本身就是向下取整，负数也不需要分支
+        return offset >> buffer_shift;
+    }
+    const difference_type size = static_cast<difference_type>(buffer_size());
+    return offset >= 0 ? offset / size : -((-offset - 1) / size) - 1;
 }
 
 // 更新迭代器的状态
-template <typename T>
-void deque_iterator<T>::set_node(map_pointer new_node) {
+template <typename T, size_t BufSize>
+void deque_iterator<T, BufSize>::set_node(map_pointer new_node) {
     node = new_node;
     first = *node;
     last = first + buffer_size();
 }
 
 // 构造函数
-template <typename T>
-deque_iterator<T>::deque_iterator(T *value, map_pointer new_node)
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize>::deque_iterator(T *value, map_pointer new_node)
     : cur(value),
       first(*new_node),
       last(first + buffer_size()),
       node(new_node) {}
 
-template <typename T>
-deque_iterator<T>::deque_iterator(const deque_iterator &rhs)
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize>::deque_iterator(const deque_iterator &rhs)
     : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {}
 
-template <typename T>
-deque_iterator<T>::deque_iterator()
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize>::deque_iterator()
     : cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {}
 
 // 重载运算符
-template <typename T>
-typename deque_iterator<T>::difference_type deque_iterator<T>::operator-(
-    const deque_iterator<T> &rhs) const {
-    return (node - rhs.node) * buffer_size() + (cur - first) -
-           (rhs.cur - rhs.first);
+template <typename T, size_t BufSize>
+typename deque_iterator<T, BufSize>::difference_type
+deque_iterator<T, BufSize>::operator-(const deque_iterator &rhs) const {
+    // buffer_size()是编译期常量，2的幂时这里的乘法就是移位
+    return (node - rhs.node) * static_cast<difference_type>(buffer_size()) +
+           (cur - first) - (rhs.cur - rhs.first);
 }
 
-template <typename T>
-typename deque_iterator<T>::reference deque_iterator<T>::operator*() const {
+template <typename T, size_t BufSize>
+typename deque_iterator<T, BufSize>::reference
+deque_iterator<T, BufSize>::operator*() const {
     return *cur;
 }
 
-template <typename T>
-typename deque_iterator<T>::pointer deque_iterator<T>::operator->() const {
+template <typename T, size_t BufSize>
+typename deque_iterator<T, BufSize>::pointer
+deque_iterator<T, BufSize>::operator->() const {
     return &(operator*());
 }
 
-template <typename T>
-deque_iterator<T> &deque_iterator<T>::operator++() {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> &deque_iterator<T, BufSize>::operator++() {
     ++cur;
     if (cur == last) {
         set_node(node + 1);
@@ -130,15 +164,15 @@ deque_iterator<T> &deque_iterator<T>::operator++() {
     return *this;
 }
 
-template <typename T>
-deque_iterator<T> deque_iterator<T>::operator++(int) {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> deque_iterator<T, BufSize>::operator++(int) {
     deque_iterator tmp = *this;
     ++(*this);
     return tmp;
 }
 
-template <typename T>
-deque_iterator<T> &deque_iterator<T>::operator--() {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> &deque_iterator<T, BufSize>::operator--() {
     if (cur == first) {
         set_node(node - 1);
         cur = last;
@@ -147,79 +181,82 @@ deque_iterator<T> &deque_iterator<T>::operator--() {
     return *this;
 }
 
-template <typename T>
-deque_iterator<T> deque_iterator<T>::operator--(int) {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> deque_iterator<T, BufSize>::operator--(int) {
     deque_iterator tmp = *this;
     --(*this);
     return tmp;
 }
 
-template <typename T>
-deque_iterator<T> deque_iterator<T>::operator+(difference_type n) const {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> deque_iterator<T, BufSize>::operator+(
+    difference_type n) const {
     deque_iterator tmp = *this;
     return tmp += n;
 }
 
-template <typename T>
-deque_iterator<T> deque_iterator<T>::operator-(difference_type n) const {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> deque_iterator<T, BufSize>::operator-(
+    difference_type n) const {
     deque_iterator tmp = *this;
     return tmp -= n;
 }
 
-template <typename T>
-deque_iterator<T> &deque_iterator<T>::operator+=(difference_type n) {
-    difference_type offset = n + (cur - first);
-    if (offset >= 0 && offset < buffer_size())
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> &deque_iterator<T, BufSize>::operator+=(
+    difference_type n) {
+    const difference_type offset = n + (cur - first);
+    if (static_cast<size_t>(offset) < buffer_size()) {
         cur += n;
-    else {
-        difference_type node_offset =
-            offset > 0 ? offset / buffer_size()
-                       : -(((-offset - 1) / buffer_size()) + 1);
-        set_node(node + node_offset);
-        cur = first + (offset - node_offset * buffer_size());
+    } else {
+        const difference_type step = node_offset(offset);
+        set_node(node + step);
+        cur = first + (offset -
+                       step * static_cast<difference_type>(buffer_size()));
     }
     return *this;
 }
 
-template <typename T>
-deque_iterator<T> &deque_iterator<T>::operator-=(difference_type n) {
+template <typename T, size_t BufSize>
+deque_iterator<T, BufSize> &deque_iterator<T, BufSize>::operator-=(
+    difference_type n) {
     return *this += -n;
 }
 
-template <typename T>
-typename deque_iterator<T>::reference deque_iterator<T>::operator[](
-    difference_type n) const {
+template <typename T, size_t BufSize>
+typename deque_iterator<T, BufSize>::reference
+deque_iterator<T, BufSize>::operator[](difference_type n) const {
     return *(*this + n);
 }
 
 // 重载比较运算符
-template <typename T>
-bool deque_iterator<T>::operator==(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator==(const deque_iterator &rhs) const {
     return cur == rhs.cur;
 }
 
-template <typename T>
-bool deque_iterator<T>::operator!=(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator!=(const deque_iterator &rhs) const {
     return !(*this == rhs);
 }
 
-template <typename T>
-bool deque_iterator<T>::operator<(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator<(const deque_iterator &rhs) const {
     return (node == rhs.node) ? (cur < rhs.cur) : (node < rhs.node);
 }
 
-template <typename T>
-bool deque_iterator<T>::operator<=(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator<=(const deque_iterator &rhs) const {
     return *this < rhs || *this == rhs;
 }
 
-template <typename T>
-bool deque_iterator<T>::operator>(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator>(const deque_iterator &rhs) const {
     return (node == rhs.node) ? (cur > rhs.cur) : (node > rhs.node);
 }
 
-template <typename T>
-bool deque_iterator<T>::operator>=(const deque_iterator &rhs) const {
+template <typename T, size_t BufSize>
+bool deque_iterator<T, BufSize>::operator>=(const deque_iterator &rhs) const {
     return *this > rhs || *this == rhs;
 }
 }  // namespace mystl
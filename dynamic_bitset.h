@@ -0,0 +1,351 @@
+#pragma once
+
+// 动态位集，按64位字紧凑存储，每个标志只占1位
+// count/find_first/find_next和按位运算都以字为单位处理，count使用simd::popcount
+
+#include <cstdint>
+
+#include "exceptdef.h"
+#include "simd.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+template <typename Alloc = simple_alloc<uint64_t>>
+class dynamic_bitset {
+   public:
+    using block_type = uint64_t;
+    using size_type = size_t;
+    using allocator_type = Alloc;
+
+    static constexpr size_type bits_per_block = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // 单个位的代理引用
+    class reference {
+       public:
+        reference(block_type *block, size_type bit)
+            : block(block), mask(block_type(1) << bit) {}
+
+        operator bool() const { return (*block & mask) != 0; }
+        bool operator~() const { return (*block & mask) == 0; }
+        reference &operator=(bool value) {
+            if (value) {
+                *block |= mask;
+            } else {
+                *block &= ~mask;
+            }
+            return *this;
+        }
+        reference &operator=(const reference &rhs) {
+            return *this = static_cast<bool>(rhs);
+        }
+        reference &flip() {
+            *block ^= mask;
+            return *this;
+        }
+
+       private:
+        block_type *block;
+        block_type mask;
+    };
+
+   protected:
+    vector<block_type, Alloc> blocks;
+    size_type nbits;
+
+    static size_type block_index(size_type pos) { return pos / bits_per_block; }
+    static size_type bit_index(size_type pos) { return pos % bits_per_block; }
+    static size_type calc_num_blocks(size_type n) {
+        return (n + bits_per_block - 1) / bits_per_block;
+    }
+
+    // 最后一个字中超出size()的高位始终保持为0
+    void zero_unused_bits();
+
+   public:
+    // 构造函数
+    dynamic_bitset() : blocks(), nbits(0) {}
+    explicit dynamic_bitset(size_type n, bool value = false)
+        : blocks(calc_num_blocks(n), value ? ~block_type(0) : block_type(0)),
+          nbits(n) {
+        zero_unused_bits();
+    }
+
+    // 容量
+    size_type size() const { return nbits; }
+    size_type num_blocks() const { return blocks.size(); }
+    bool empty() const { return nbits == 0; }
+
+    // 原始字数据，可用于批量读写
+    block_type *data() { return blocks.begin(); }
+    const block_type *data() const { return blocks.begin(); }
+
+    // 访问
+    bool test(size_type pos) const;
+    bool operator[](size_type pos) const { return test(pos); }
+    reference operator[](size_type pos) {
+        return reference(blocks.begin() + block_index(pos), bit_index(pos));
+    }
+
+    // 修改
+    void resize(size_type n, bool value = false);
+    void clear();
+    void push_back(bool value);
+
+    dynamic_bitset &set();
+    dynamic_bitset &set(size_type pos, bool value = true);
+    dynamic_bitset &reset();
+    dynamic_bitset &reset(size_type pos);
+    dynamic_bitset &flip();
+    dynamic_bitset &flip(size_type pos);
+
+    // 统计与查找
+    size_type count() const;
+    bool any() const;
+    bool none() const { return !any(); }
+    bool all() const { return count() == nbits; }
+    size_type find_first() const;
+    size_type find_next(size_type pos) const;
+
+    // 按位运算，两个位集大小必须相同
+    dynamic_bitset &operator&=(const dynamic_bitset &rhs);
+    dynamic_bitset &operator|=(const dynamic_bitset &rhs);
+    dynamic_bitset &operator^=(const dynamic_bitset &rhs);
+    dynamic_bitset &operator-=(const dynamic_bitset &rhs);
+    dynamic_bitset operator~() const;
+
+    void swap(dynamic_bitset &rhs) {
+        blocks.swap(rhs.blocks);
+        mystl::swap(nbits, rhs.nbits);
+    }
+
+    bool operator==(const dynamic_bitset &rhs) const {
+        return nbits == rhs.nbits && blocks == rhs.blocks;
+    }
+    bool operator!=(const dynamic_bitset &rhs) const { return !(*this == rhs); }
+};
+
+template <typename Alloc>
+void dynamic_bitset<Alloc>::zero_unused_bits() {
+    const size_type extra = bit_index(nbits);
+    if (extra != 0) {
+        blocks.back() &= (block_type(1) << extra) - 1;
+    }
+}
+
+template <typename Alloc>
+bool dynamic_bitset<Alloc>::test(size_type pos) const {
+    return (blocks.begin()[block_index(pos)] >> bit_index(pos)) & 1;
+}
+
+template <typename Alloc>
+void dynamic_bitset<Alloc>::resize(size_type n, bool value) {
+    const size_type old_nbits = nbits;
+    const block_type fill = value ? ~block_type(0) : block_type(0);
+    // 原最后一个字中未使用的高位要先补上value
+    if (value && n > old_nbits && bit_index(old_nbits) != 0) {
+        blocks.back() |= ~block_type(0) << bit_index(old_nbits);
+    }
+    blocks.resize(calc_num_blocks(n), fill);
+    nbits = n;
+    zero_unused_bits();
+}
+
+template <typename Alloc>
+void dynamic_bitset<Alloc>::clear() {
+    blocks.clear();
+    nbits = 0;
+}
+
+template <typename Alloc>
+void dynamic_bitset<Alloc>::push_back(bool value) {
+    if (bit_index(nbits) == 0) {
+        blocks.push_back(block_type(0));
+    }
+    ++nbits;
+    set(nbits - 1, value);
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::set() {
+    std::fill(blocks.begin(), blocks.end(), ~block_type(0));
+    zero_unused_bits();
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::set(size_type pos, bool value) {
+    MYSTL_OUT_OF_RANGE_IF(pos >= nbits, "dynamic_bitset<Alloc>::set");
+    (*this)[pos] = value;
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::reset() {
+    std::fill(blocks.begin(), blocks.end(), block_type(0));
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::reset(size_type pos) {
+    return set(pos, false);
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::flip() {
+    block_type *p = blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        p[i] = ~p[i];
+    }
+    zero_unused_bits();
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::flip(size_type pos) {
+    MYSTL_OUT_OF_RANGE_IF(pos >= nbits, "dynamic_bitset<Alloc>::flip");
+    (*this)[pos].flip();
+    return *this;
+}
+
+template <typename Alloc>
+typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::count()
+    const {
+    return simd::popcount(blocks.begin(), blocks.size());
+}
+
+template <typename Alloc>
+bool dynamic_bitset<Alloc>::any() const {
+    const block_type *p = blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        if (p[i] != 0) return true;
+    }
+    return false;
+}
+
+template <typename Alloc>
+typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::find_first()
+    const {
+    const block_type *p = blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        if (p[i] != 0) return i * bits_per_block + simd::ctz64(p[i]);
+    }
+    return npos;
+}
+
+// 返回pos之后(不含pos)第一个置位的下标，没有则返回npos
+template <typename Alloc>
+typename dynamic_bitset<Alloc>::size_type dynamic_bitset<Alloc>::find_next(
+    size_type pos) const {
+    if (pos == npos || pos + 1 >= nbits) return npos;
+    ++pos;
+    const block_type *p = blocks.begin();
+    const size_type n = blocks.size();
+    size_type i = block_index(pos);
+    const block_type first_block = p[i] & (~block_type(0) << bit_index(pos));
+    if (first_block != 0) {
+        return i * bits_per_block + simd::ctz64(first_block);
+    }
+    for (++i; i < n; ++i) {
+        if (p[i] != 0) return i * bits_per_block + simd::ctz64(p[i]);
+    }
+    return npos;
+}
+
+// 按字运算的循环足够简单，编译器会自动向量化
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::operator&=(
+    const dynamic_bitset &rhs) {
+    MYSTL_DEBUG(nbits == rhs.nbits);
+    block_type *p = blocks.begin();
+    const block_type *q = rhs.blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        p[i] &= q[i];
+    }
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::operator|=(
+    const dynamic_bitset &rhs) {
+    MYSTL_DEBUG(nbits == rhs.nbits);
+    block_type *p = blocks.begin();
+    const block_type *q = rhs.blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        p[i] |= q[i];
+    }
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::operator^=(
+    const dynamic_bitset &rhs) {
+    MYSTL_DEBUG(nbits == rhs.nbits);
+    block_type *p = blocks.begin();
+    const block_type *q = rhs.blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        p[i] ^= q[i];
+    }
+    return *this;
+}
+
+// 差集：清除rhs中置位的位
+template <typename Alloc>
+dynamic_bitset<Alloc> &dynamic_bitset<Alloc>::operator-=(
+    const dynamic_bitset &rhs) {
+    MYSTL_DEBUG(nbits == rhs.nbits);
+    block_type *p = blocks.begin();
+    const block_type *q = rhs.blocks.begin();
+    const size_type n = blocks.size();
+    for (size_type i = 0; i < n; ++i) {
+        p[i] &= ~q[i];
+    }
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> dynamic_bitset<Alloc>::operator~() const {
+    dynamic_bitset tmp(*this);
+    tmp.flip();
+    return tmp;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc> &lhs,
+                                const dynamic_bitset<Alloc> &rhs) {
+    dynamic_bitset<Alloc> tmp(lhs);
+    tmp &= rhs;
+    return tmp;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc> &lhs,
+                                const dynamic_bitset<Alloc> &rhs) {
+    dynamic_bitset<Alloc> tmp(lhs);
+    tmp |= rhs;
+    return tmp;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc> &lhs,
+                                const dynamic_bitset<Alloc> &rhs) {
+    dynamic_bitset<Alloc> tmp(lhs);
+    tmp ^= rhs;
+    return tmp;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc> &lhs,
+                                const dynamic_bitset<Alloc> &rhs) {
+    dynamic_bitset<Alloc> tmp(lhs);
+    tmp -= rhs;
+    return tmp;
+}
+}  // namespace mystl
@@ -0,0 +1,539 @@
+#pragma once
+
+// 单向链表：节点只有next指针，比list_node少一个指针，
+// 小元素的节点因此落在MemoryPoolManager更小的尺寸档中。
+// 与std::forward_list一样在给定位置之后插入删除，不维护元素个数。
+// 链表头直接放在对象里，before_begin()指向它。
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#include "alloc.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "list.h"
+#include "util.h"
+
+namespace mystl {
+struct forward_list_node_base {
+    forward_list_node_base *next;
+};
+
+template <typename T>
+struct forward_list_node : forward_list_node_base {
+    T data;
+};
+
+template <typename T, bool Const>
+class forward_list_iterator {
+   public:
+    using iterator_category = forward_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::conditional<Const, const T *, T *>::type;
+    using reference = typename std::conditional<Const, const T &, T &>::type;
+
+    forward_list_node_base *node;
+
+    // 构造函数
+    forward_list_iterator() : node(nullptr) {}
+    explicit forward_list_iterator(forward_list_node_base *x) : node(x) {}
+    template <bool C, typename = typename std::enable_if<Const && !C>::type>
+    forward_list_iterator(const forward_list_iterator<T, C> &rhs)
+        : node(rhs.node) {}
+
+    reference operator*() const {
+        return static_cast<forward_list_node<T> *>(node)->data;
+    }
+    pointer operator->() const { return &(operator*()); }
+
+    forward_list_iterator &operator++() {
+        node = node->next;
+        return *this;
+    }
+    forward_list_iterator operator++(int) {
+        forward_list_iterator tmp = *this;
+        node = node->next;
+        return tmp;
+    }
+
+    bool operator==(const forward_list_iterator &rhs) const {
+        return node == rhs.node;
+    }
+    bool operator!=(const forward_list_iterator &rhs) const {
+        return node != rhs.node;
+    }
+};
+
+template <typename T,
+          typename Alloc = mystl::simple_alloc<forward_list_node<T>>>
+class forward_list {
+   public:
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = forward_list_iterator<T, false>;
+    using const_iterator = forward_list_iterator<T, true>;
+
+   protected:
+    using base_ptr = forward_list_node_base *;
+    using link_type = forward_list_node<T> *;
+
+    forward_list_node_base head;
+
+    // 辅助函数
+    link_type get_node() { return Alloc::allocate(); }
+    void put_node(link_type p) { Alloc::deallocate(p); }
+    template <typename... Args>
+    link_type create_node(Args &&...args) {
+        link_type p = get_node();
+        try {
+            mystl::construct(&p->data, mystl::forward<Args>(args)...);
+            return p;
+        } catch (const std::exception &e) {
+            put_node(p);
+            throw;
+        }
+    }
+    void destroy_node(link_type p) {
+        mystl::destroy(&p->data);
+        put_node(p);
+    }
+    static T &value(base_ptr p) { return static_cast<link_type>(p)->data; }
+
+    // 把(before_first, last)接到pos之后
+    static void transfer_after(base_ptr pos, base_ptr before_first,
+                               base_ptr before_last);
+
+    // 不少于这么多个元素时sort改用节点指针数组排序
+    static constexpr size_type sort_array_threshold = 256;
+    bool sort_by_array(size_type n);
+
+   public:
+    // 构造函数
+    forward_list() { head.next = nullptr; }
+    explicit forward_list(size_type n) : forward_list() {
+        insert_after(before_begin(), n, value_type());
+    }
+    forward_list(size_type n, const value_type &x) : forward_list() {
+        insert_after(before_begin(), n, x);
+    }
+    template <typename InputIterator,
+              typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                      int>::type = 0>
+    forward_list(InputIterator first, InputIterator last) : forward_list() {
+        insert_after(before_begin(), first, last);
+    }
+    forward_list(std::initializer_list<value_type> il) : forward_list() {
+        insert_after(before_begin(), il.begin(), il.end());
+    }
+    forward_list(const forward_list &rhs) : forward_list() {
+        insert_after(before_begin(), rhs.begin(), rhs.end());
+    }
+    forward_list(forward_list &&rhs) noexcept {
+        head.next = rhs.head.next;
+        rhs.head.next = nullptr;
+    }
+
+    forward_list &operator=(const forward_list &rhs) {
+        if (this != &rhs) {
+            forward_list tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+    forward_list &operator=(forward_list &&rhs) noexcept {
+        if (this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+    forward_list &operator=(std::initializer_list<value_type> il) {
+        forward_list tmp(il);
+        swap(tmp);
+        return *this;
+    }
+
+    // 析构函数
+    ~forward_list() { clear(); }
+
+    // 迭代器操作
+    iterator before_begin() { return iterator(&head); }
+    const_iterator before_begin() const {
+        return const_iterator(const_cast<base_ptr>(&head));
+    }
+    const_iterator cbefore_begin() const { return before_begin(); }
+    iterator begin() { return iterator(head.next); }
+    const_iterator begin() const { return const_iterator(head.next); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(nullptr); }
+    const_iterator end() const { return const_iterator(nullptr); }
+    const_iterator cend() const { return end(); }
+
+    // 容器容量操作，size()需要遍历
+    bool empty() const { return head.next == nullptr; }
+    size_type size() const {
+        size_type n = 0;
+        for (base_ptr p = head.next; p != nullptr; p = p->next) ++n;
+        return n;
+    }
+    size_type max_size() const {
+        return size_type(-1) / sizeof(forward_list_node<T>);
+    }
+
+    // 元素访问操作
+    reference front() {
+        MYSTL_DEBUG(!empty());
+        return value(head.next);
+    }
+    const_reference front() const {
+        MYSTL_DEBUG(!empty());
+        return value(head.next);
+    }
+
+    // 修改链表操作，插入删除都在position之后
+    template <typename... Args>
+    iterator emplace_after(const_iterator position, Args &&...args) {
+        link_type p = create_node(mystl::forward<Args>(args)...);
+        p->next = position.node->next;
+        position.node->next = p;
+        return iterator(p);
+    }
+    iterator insert_after(const_iterator position, const value_type &x) {
+        return emplace_after(position, x);
+    }
+    iterator insert_after(const_iterator position, value_type &&x) {
+        return emplace_after(position, mystl::move(x));
+    }
+    iterator insert_after(const_iterator position, size_type n,
+                          const value_type &x);
+    template <typename InputIterator,
+              typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                      int>::type = 0>
+    iterator insert_after(const_iterator position, InputIterator first,
+                          InputIterator last);
+    iterator insert_after(const_iterator position,
+                          std::initializer_list<value_type> il) {
+        return insert_after(position, il.begin(), il.end());
+    }
+
+    template <typename... Args>
+    reference emplace_front(Args &&...args) {
+        return *emplace_after(before_begin(), mystl::forward<Args>(args)...);
+    }
+    void push_front(const value_type &x) { emplace_front(x); }
+    void push_front(value_type &&x) { emplace_front(mystl::move(x)); }
+    void pop_front() {
+        MYSTL_DEBUG(!empty());
+        erase_after(before_begin());
+    }
+
+    // 删除position之后的一个元素，返回被删元素之后的位置
+    iterator erase_after(const_iterator position) {
+        base_ptr p = position.node->next;
+        position.node->next = p->next;
+        destroy_node(static_cast<link_type>(p));
+        return iterator(position.node->next);
+    }
+    // 删除(position, last)
+    iterator erase_after(const_iterator position, const_iterator last);
+
+    void clear() { erase_after(before_begin(), end()); }
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+    void resize(size_type new_size, const value_type &x);
+    void swap(forward_list &rhs) noexcept {
+        mystl::swap(head.next, rhs.head.next);
+    }
+
+    void remove(const value_type &x) {
+        remove_if([&](const value_type &v) { return v == x; });
+    }
+    template <typename Predicate>
+    void remove_if(Predicate pred);
+    void unique();
+    void reverse();
+    // 稳定排序，与list::sort相同：已经有序时只扫描一遍，
+    // 大链表用节点指针数组排序，否则用64路归并
+    void sort();
+    void merge(forward_list &other);
+
+    // 链表移动，都是修改指针，不复制元素
+    void splice_after(const_iterator position, forward_list &other);
+    // 移动i之后的一个元素
+    void splice_after(const_iterator position, forward_list &other,
+                      const_iterator i);
+    // 移动(first, last)，需要走到last之前的节点，代价与区间长度成正比
+    void splice_after(const_iterator position, forward_list &other,
+                      const_iterator first, const_iterator last);
+};
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::transfer_after(base_ptr pos,
+                                            base_ptr before_first,
+                                            base_ptr before_last) {
+    if (pos == before_first || pos == before_last) return;
+    base_ptr first = before_first->next;
+    before_first->next = before_last->next;
+    before_last->next = pos->next;
+    pos->next = first;
+}
+
+template <typename T, typename Alloc>
+typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::insert_after(
+    const_iterator position, size_type n, const value_type &x) {
+    iterator cur(position.node);
+    for (; n > 0; --n) {
+        cur = emplace_after(cur, x);
+    }
+    return cur;
+}
+
+// 返回最后插入的元素
+template <typename T, typename Alloc>
+template <typename InputIterator,
+          typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                  int>::type>
+typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::insert_after(
+    const_iterator position, InputIterator first, InputIterator last) {
+    iterator cur(position.node);
+    for (; first != last; ++first) {
+        cur = emplace_after(cur, *first);
+    }
+    return cur;
+}
+
+template <typename T, typename Alloc>
+typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::erase_after(
+    const_iterator position, const_iterator last) {
+    base_ptr p = position.node->next;
+    while (p != last.node) {
+        base_ptr next = p->next;
+        destroy_node(static_cast<link_type>(p));
+        p = next;
+    }
+    position.node->next = last.node;
+    return iterator(last.node);
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::resize(size_type new_size, const value_type &x) {
+    base_ptr prev = &head;
+    for (; prev->next != nullptr && new_size > 0; --new_size) {
+        prev = prev->next;
+    }
+    if (prev->next != nullptr) {
+        erase_after(const_iterator(prev), end());
+    } else {
+        insert_after(const_iterator(prev), new_size, x);
+    }
+}
+
+template <typename T, typename Alloc>
+template <typename Predicate>
+void forward_list<T, Alloc>::remove_if(Predicate pred) {
+    base_ptr prev = &head;
+    while (prev->next != nullptr) {
+        if (pred(value(prev->next))) {
+            erase_after(const_iterator(prev));
+        } else {
+            prev = prev->next;
+        }
+    }
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::unique() {
+    base_ptr p = head.next;
+    if (p == nullptr) return;
+    while (p->next != nullptr) {
+        if (value(p) == value(p->next)) {
+            erase_after(const_iterator(p));
+        } else {
+            p = p->next;
+        }
+    }
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::reverse() {
+    base_ptr prev = nullptr;
+    base_ptr p = head.next;
+    while (p != nullptr) {
+        base_ptr next = p->next;
+        p->next = prev;
+        prev = p;
+        p = next;
+    }
+    head.next = prev;
+}
+
+// 默认有序
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::merge(forward_list &other) {
+    if (this == &other) return;
+    base_ptr prev = &head;
+    while (prev->next != nullptr && other.head.next != nullptr) {
+        if (value(other.head.next) < value(prev->next)) {
+            transfer_after(prev, &other.head, other.head.next);
+        }
+        prev = prev->next;
+    }
+    if (other.head.next != nullptr) {
+        prev->next = other.head.next;
+        other.head.next = nullptr;
+    }
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::sort() {
+    base_ptr p = head.next;
+    if (p == nullptr || p->next == nullptr) return;
+
+    size_type n = 1;
+    for (; p->next != nullptr && !(value(p->next) < value(p)); p = p->next) {
+        ++n;
+    }
+    if (p->next == nullptr) return;
+    for (base_ptr q = p->next; q != nullptr; q = q->next) ++n;
+
+    if (n >= sort_array_threshold && sort_by_array(n)) return;
+
+    forward_list carry;
+    forward_list counter[64];
+    int fill = 0;
+    while (!empty()) {
+        transfer_after(&carry.head, &head, head.next);
+        int i = 0;
+        while (i < fill && !counter[i].empty()) {
+            counter[i].merge(carry);
+            carry.swap(counter[i++]);
+        }
+        carry.swap(counter[i]);
+        if (i == fill) ++fill;
+    }
+    for (int i = 1; i < fill; ++i) {
+        counter[i].merge(counter[i - 1]);
+    }
+    swap(counter[fill - 1]);
+}
+
+// 节点指针排好序后按数组顺序重新链接，比较抛出异常时链表保持不变
+template <typename T, typename Alloc>
+bool forward_list<T, Alloc>::sort_by_array(size_type n) {
+    using ptr_alloc = typename Alloc::template rebind<base_ptr>::other;
+    using bound_alloc = typename Alloc::template rebind<size_t>::other;
+
+    const size_type bn = detail::list_sort_bounds_size(n);
+    base_ptr *a = nullptr;
+    base_ptr *b = nullptr;
+    size_t *bounds = nullptr;
+    try {
+        a = ptr_alloc::allocate(n);
+        b = ptr_alloc::allocate(n);
+        bounds = bound_alloc::allocate(bn);
+    } catch (const std::bad_alloc &) {
+        ptr_alloc::deallocate(a, n);
+        ptr_alloc::deallocate(b, n);
+        return false;
+    }
+
+    base_ptr p = head.next;
+    for (size_type i = 0; i < n; ++i, p = p->next) {
+        a[i] = p;
+    }
+    base_ptr *sorted;
+    try {
+        sorted = detail::list_sort_array(
+            a, b, n, bounds,
+            [](base_ptr x, base_ptr y) { return value(x) < value(y); });
+    } catch (const std::exception &e) {
+        ptr_alloc::deallocate(a, n);
+        ptr_alloc::deallocate(b, n);
+        bound_alloc::deallocate(bounds, bn);
+        throw;
+    }
+
+    base_ptr prev = &head;
+    for (size_type i = 0; i < n; ++i) {
+        prev->next = sorted[i];
+        prev = sorted[i];
+    }
+    prev->next = nullptr;
+
+    ptr_alloc::deallocate(a, n);
+    ptr_alloc::deallocate(b, n);
+    bound_alloc::deallocate(bounds, bn);
+    return true;
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::splice_after(const_iterator position,
+                                          forward_list &other) {
+    if (this == &other || other.empty()) return;
+    base_ptr last = &other.head;
+    while (last->next != nullptr) last = last->next;
+    transfer_after(position.node, &other.head, last);
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::splice_after(const_iterator position,
+                                          forward_list &,
+                                          const_iterator i) {
+    base_ptr p = i.node->next;
+    if (p == nullptr) return;
+    transfer_after(position.node, i.node, p);
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::splice_after(const_iterator position,
+                                          forward_list &,
+                                          const_iterator first,
+                                          const_iterator last) {
+    if (first.node->next == last.node) return;
+    base_ptr before_last = first.node;
+    while (before_last->next != last.node) before_last = before_last->next;
+    transfer_after(position.node, first.node, before_last);
+}
+
+// 比较操作
+template <typename T, typename Alloc>
+bool operator==(const forward_list<T, Alloc> &lhs,
+                const forward_list<T, Alloc> &rhs) {
+    auto first1 = lhs.begin(), first2 = rhs.begin();
+    for (; first1 != lhs.end() && first2 != rhs.end(); ++first1, ++first2) {
+        if (!(*first1 == *first2)) return false;
+    }
+    return first1 == lhs.end() && first2 == rhs.end();
+}
+
+template <typename T, typename Alloc>
+bool operator!=(const forward_list<T, Alloc> &lhs,
+                const forward_list<T, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc>
+bool operator<(const forward_list<T, Alloc> &lhs,
+               const forward_list<T, Alloc> &rhs) {
+    auto first1 = lhs.begin(), first2 = rhs.begin();
+    for (; first1 != lhs.end() && first2 != rhs.end(); ++first1, ++first2) {
+        if (*first1 < *first2) return true;
+        if (*first2 < *first1) return false;
+    }
+    return first1 == lhs.end() && first2 != rhs.end();
+}
+
+template <typename T, typename Alloc>
+void swap(forward_list<T, Alloc> &lhs, forward_list<T, Alloc> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace mystl
@@ -0,0 +1,439 @@
+#pragma once
+
+// 侵入式双向链表：元素自己继承钩子(prev/next)，链表只负责链接，从不分配内存，
+// 也不拷贝、不析构元素，元素的生命周期由使用者(例如对象池)管理。
+// 一个元素可以继承多个带不同Tag的钩子，从而同时挂在多个链表上。
+// 钩子有两种模式：
+//   link_mode::normal：链表维护元素个数，size()为O(1)；
+//                      元素析构前必须先从链表中移除。
+//   link_mode::auto_unlink：元素析构时自动从所在链表摘除，也可以直接调用
+//                      hook.unlink()，不需要知道链表；链表因此不能维护个数，
+//                      size()需要遍历。
+// 钩子被拷贝时不拷贝链接关系。splice/merge/sort与list采用相同的算法。
+
+#include <cstddef>
+
+#include "exceptdef.h"
+#include "functional.h"
+#include "iterator.h"
+
+namespace mystl {
+enum class link_mode { normal, auto_unlink };
+
+// 链表头和钩子共用的链接部分
+struct intrusive_list_node {
+    intrusive_list_node *prev;
+    intrusive_list_node *next;
+
+    intrusive_list_node() : prev(nullptr), next(nullptr) {}
+
+    bool is_linked() const { return next != nullptr; }
+    // 摘下自身，返回原来的下一个节点
+    intrusive_list_node *unlink() {
+        intrusive_list_node *n = next;
+        prev->next = next;
+        next->prev = prev;
+        prev = next = nullptr;
+        return n;
+    }
+    // 链接到pos之前
+    void link_before(intrusive_list_node *pos) {
+        prev = pos->prev;
+        next = pos;
+        pos->prev->next = this;
+        pos->prev = this;
+    }
+};
+
+template <typename Tag = void, link_mode Mode = link_mode::normal>
+class intrusive_list_hook : public intrusive_list_node {
+   public:
+    static constexpr link_mode mode = Mode;
+
+    intrusive_list_hook() {}
+    intrusive_list_hook(const intrusive_list_hook &) {}
+    intrusive_list_hook &operator=(const intrusive_list_hook &) {
+        return *this;
+    }
+    ~intrusive_list_hook() {
+        if (Mode == link_mode::auto_unlink) {
+            if (is_linked()) intrusive_list_node::unlink();
+        } else {
+            MYSTL_DEBUG(!is_linked());
+        }
+    }
+
+    bool is_linked() const { return intrusive_list_node::is_linked(); }
+    // 只有auto_unlink模式可以绕过链表直接摘除
+    void unlink() {
+        static_assert(Mode == link_mode::auto_unlink,
+                      "unlink() without the list requires an auto_unlink hook");
+        if (is_linked()) intrusive_list_node::unlink();
+    }
+};
+
+template <typename T, typename Hook, bool Const>
+class intrusive_list_iterator {
+   public:
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::conditional<Const, const T *, T *>::type;
+    using reference = typename std::conditional<Const, const T &, T &>::type;
+
+    intrusive_list_node *node;
+
+    intrusive_list_iterator() : node(nullptr) {}
+    explicit intrusive_list_iterator(intrusive_list_node *x) : node(x) {}
+    // iterator可以转换为const_iterator
+    template <bool C, typename = typename std::enable_if<Const && !C>::type>
+    intrusive_list_iterator(const intrusive_list_iterator<T, Hook, C> &rhs)
+        : node(rhs.node) {}
+
+    reference operator*() const {
+        return *static_cast<pointer>(static_cast<Hook *>(node));
+    }
+    pointer operator->() const { return &operator*(); }
+
+    intrusive_list_iterator &operator++() {
+        node = node->next;
+        return *this;
+    }
+    intrusive_list_iterator operator++(int) {
+        intrusive_list_iterator tmp = *this;
+        node = node->next;
+        return tmp;
+    }
+    intrusive_list_iterator &operator--() {
+        node = node->prev;
+        return *this;
+    }
+    intrusive_list_iterator operator--(int) {
+        intrusive_list_iterator tmp = *this;
+        node = node->prev;
+        return tmp;
+    }
+
+    bool operator==(const intrusive_list_iterator &rhs) const {
+        return node == rhs.node;
+    }
+    bool operator!=(const intrusive_list_iterator &rhs) const {
+        return node != rhs.node;
+    }
+};
+
+template <typename T, typename Hook = intrusive_list_hook<>>
+class intrusive_list {
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = intrusive_list_iterator<T, Hook, false>;
+    using const_iterator = intrusive_list_iterator<T, Hook, true>;
+
+    // auto_unlink的元素可能被绕过链表摘除，此时无法维护个数
+    static constexpr bool constant_time_size =
+        Hook::mode == link_mode::normal;
+
+   protected:
+    using node_type = intrusive_list_node;
+
+    node_type header;
+    size_type count;
+
+    static node_type *to_node(T &x) {
+        return static_cast<node_type *>(static_cast<Hook *>(&x));
+    }
+
+    void init() {
+        header.prev = header.next = &header;
+        count = 0;
+    }
+    void add_count(size_type n) {
+        if (constant_time_size) count += n;
+    }
+    void sub_count(size_type n) {
+        if (constant_time_size) count -= n;
+    }
+
+    // 把[first, last)移动到position之前，不维护个数
+    static void transfer(node_type *position, node_type *first,
+                         node_type *last);
+
+   public:
+    // 构造函数
+    intrusive_list() { init(); }
+    intrusive_list(const intrusive_list &) = delete;
+    intrusive_list &operator=(const intrusive_list &) = delete;
+    intrusive_list(intrusive_list &&rhs) noexcept {
+        init();
+        swap(rhs);
+    }
+    intrusive_list &operator=(intrusive_list &&rhs) noexcept {
+        if (this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    // 析构函数，只摘除元素，不析构
+    ~intrusive_list() { clear(); }
+
+    // 迭代器
+    iterator begin() { return iterator(header.next); }
+    const_iterator begin() const {
+        return const_iterator(const_cast<node_type *>(header.next));
+    }
+    iterator end() { return iterator(&header); }
+    const_iterator end() const {
+        return const_iterator(const_cast<node_type *>(&header));
+    }
+    // 由元素得到迭代器，O(1)
+    iterator iterator_to(T &x) { return iterator(to_node(x)); }
+    const_iterator iterator_to(const T &x) const {
+        return const_iterator(to_node(const_cast<T &>(x)));
+    }
+
+    // 容量
+    bool empty() const { return header.next == &header; }
+    size_type size() const {
+        if (constant_time_size) return count;
+        size_type n = 0;
+        for (const node_type *p = header.next; p != &header; p = p->next) ++n;
+        return n;
+    }
+
+    // 访问
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *iterator(header.prev); }
+    const_reference back() const {
+        return *const_iterator(const_cast<node_type *>(header.prev));
+    }
+
+    // 修改，x不能已经在某个链表中
+    iterator insert(const_iterator position, T &x) {
+        node_type *n = to_node(x);
+        MYSTL_DEBUG(!n->is_linked());
+        n->link_before(position.node);
+        add_count(1);
+        return iterator(n);
+    }
+    void push_front(T &x) { insert(begin(), x); }
+    void push_back(T &x) { insert(end(), x); }
+
+    // 只摘除不析构，返回下一个位置
+    iterator erase(const_iterator position) {
+        sub_count(1);
+        return iterator(position.node->unlink());
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.node);
+    }
+    // 由元素直接摘除，O(1)
+    void erase(T &x) { erase(iterator_to(x)); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(header.prev)); }
+
+    // 摘除全部元素，把它们的钩子置为未链接
+    void clear() {
+        node_type *p = header.next;
+        while (p != &header) {
+            node_type *next = p->next;
+            p->prev = p->next = nullptr;
+            p = next;
+        }
+        init();
+    }
+
+    void swap(intrusive_list &rhs);
+
+    template <typename Predicate>
+    void remove_if(Predicate pred);
+    void remove(const T &value) {
+        remove_if([&](const T &x) { return x == value; });
+    }
+    void reverse();
+
+    // splice，与list相同：整表和单个节点O(1)，区间可以给出长度n
+    void splice(const_iterator position, intrusive_list &other);
+    void splice(const_iterator position, intrusive_list &other,
+                const_iterator i);
+    void splice(const_iterator position, intrusive_list &other,
+                const_iterator first, const_iterator last);
+    void splice(const_iterator position, intrusive_list &other,
+                const_iterator first, const_iterator last, size_type n);
+
+    // 两个链表都按comp有序
+    template <typename Compare>
+    void merge(intrusive_list &other, Compare comp);
+    void merge(intrusive_list &other) { merge(other, mystl::less<T>()); }
+
+    template <typename Compare>
+    void sort(Compare comp);
+    void sort() { sort(mystl::less<T>()); }
+};
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::transfer(node_type *position, node_type *first,
+                                       node_type *last) {
+    if (position == last || first == last) return;
+    node_type *before_last = last->prev;
+    // 从原处断开
+    first->prev->next = last;
+    last->prev = first->prev;
+    // 接到position之前
+    first->prev = position->prev;
+    before_last->next = position;
+    position->prev->next = first;
+    position->prev = before_last;
+}
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::swap(intrusive_list &rhs) {
+    if (this == &rhs) return;
+    node_type *first = header.next, *last = header.prev;
+    node_type *rfirst = rhs.header.next, *rlast = rhs.header.prev;
+    const bool was_empty = empty(), rhs_empty = rhs.empty();
+    if (rhs_empty) {
+        header.prev = header.next = &header;
+    } else {
+        header.next = rfirst;
+        header.prev = rlast;
+        rfirst->prev = rlast->next = &header;
+    }
+    if (was_empty) {
+        rhs.header.prev = rhs.header.next = &rhs.header;
+    } else {
+        rhs.header.next = first;
+        rhs.header.prev = last;
+        first->prev = last->next = &rhs.header;
+    }
+    const size_type n = count;
+    count = rhs.count;
+    rhs.count = n;
+}
+
+template <typename T, typename Hook>
+template <typename Predicate>
+void intrusive_list<T, Hook>::remove_if(Predicate pred) {
+    iterator first = begin();
+    while (first != end()) {
+        if (pred(*first)) {
+            first = erase(first);
+        } else {
+            ++first;
+        }
+    }
+}
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::reverse() {
+    node_type *p = &header;
+    do {
+        node_type *tmp = p->next;
+        p->next = p->prev;
+        p->prev = tmp;
+        p = tmp;
+    } while (p != &header);
+}
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::splice(const_iterator position,
+                                     intrusive_list &other) {
+    if (other.empty()) return;
+    transfer(position.node, other.header.next, &other.header);
+    add_count(other.count);
+    other.count = 0;
+}
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::splice(const_iterator position,
+                                     intrusive_list &other, const_iterator i) {
+    node_type *n = i.node;
+    if (position.node == n || position.node == n->next) return;
+    transfer(position.node, n, n->next);
+    add_count(1);
+    other.sub_count(1);
+}
+
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::splice(const_iterator position,
+                                     intrusive_list &other,
+                                     const_iterator first,
+                                     const_iterator last) {
+    if (first == last) return;
+    if (constant_time_size && &other != this) {
+        size_type n = 0;
+        for (node_type *p = first.node; p != last.node; p = p->next) ++n;
+        add_count(n);
+        other.sub_count(n);
+    }
+    transfer(position.node, first.node, last.node);
+}
+
+// n必须等于[first, last)的长度
+template <typename T, typename Hook>
+void intrusive_list<T, Hook>::splice(const_iterator position,
+                                     intrusive_list &other,
+                                     const_iterator first, const_iterator last,
+                                     size_type n) {
+    if (first == last) return;
+    add_count(n);
+    other.sub_count(n);
+    transfer(position.node, first.node, last.node);
+}
+
+template <typename T, typename Hook>
+template <typename Compare>
+void intrusive_list<T, Hook>::merge(intrusive_list &other, Compare comp) {
+    if (this == &other) return;
+    iterator first1 = begin();
+    iterator first2 = other.begin();
+    while (first2 != other.end()) {
+        if (first1 == end() || comp(*first2, *first1)) {
+            iterator next = first2;
+            ++next;
+            transfer(first1.node, first2.node, next.node);
+            first2 = next;
+        } else {
+            ++first1;
+        }
+    }
+    add_count(other.count);
+    other.count = 0;
+}
+
+// 与list::sort相同的自底向上归并，counter[i]中存放长度为2^i的有序段
+template <typename T, typename Hook>
+template <typename Compare>
+void intrusive_list<T, Hook>::sort(Compare comp) {
+    if (header.next == &header || header.next->next == &header) return;
+
+    intrusive_list carry;
+    intrusive_list counter[64];
+    int fill = 0;
+    while (!empty()) {
+        carry.splice(carry.begin(), *this, begin());
+        int i = 0;
+        while (i < fill && !counter[i].empty()) {
+            counter[i].merge(carry, comp);
+            carry.swap(counter[i++]);
+        }
+        carry.swap(counter[i]);
+        if (i == fill) ++fill;
+    }
+    for (int i = 1; i < fill; ++i) {
+        counter[i].merge(counter[i - 1], comp);
+    }
+    swap(counter[fill - 1]);
+}
+}  // namespace mystl
@@ -21,9 +21,37 @@ struct iterator {
     typedef Reference reference;
 };
 
+// 标准库迭代器的分类标签换成本库的标签，
+// 使得按iterator_category分派的算法也能接受标准库迭代器
+template <class Category>
+struct to_mystl_category {
+    using type = Category;
+};
+template <>
+struct to_mystl_category<std::input_iterator_tag> {
+    using type = input_iterator_tag;
+};
+template <>
+struct to_mystl_category<std::output_iterator_tag> {
+    using type = output_iterator_tag;
+};
+template <>
+struct to_mystl_category<std::forward_iterator_tag> {
+    using type = forward_iterator_tag;
+};
+template <>
+struct to_mystl_category<std::bidirectional_iterator_tag> {
+    using type = bidirectional_iterator_tag;
+};
+template <>
+struct to_mystl_category<std::random_access_iterator_tag> {
+    using type = random_access_iterator_tag;
+};
+
 template <class Iterator>
 struct iterator_traits {
-    using iterator_category = typename Iterator::iterator_category;
+    using iterator_category = typename to_mystl_category<
+        typename Iterator::iterator_category>::type;
     using value_type = typename Iterator::value_type;
     using difference_type = typename Iterator::difference_type;
     using pointer = typename Iterator::pointer;
@@ -130,6 +158,12 @@ inline void advance(BidirectionalIterator &it, Distance n,
     }
 }
 
+template <typename RandomAccessIterator, typename Distance>
+inline void advance(RandomAccessIterator &it, Distance n,
+                    random_access_iterator_tag) {
+    it += n;
+}
+
 template <typename InputIterator, typename Distance>
 inline void advance(InputIterator &it, Distance n) {
     advance(it, n, iterator_category(it));
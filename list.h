@@ -1,8 +1,18 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <new>
 
 #include "alloc.h"
+#include "parallel.h"
+
+#ifdef MYSTL_PARALLEL_SORT
+#ifndef MYSTL_PARALLEL_SORT_THRESHOLD
+#define MYSTL_PARALLEL_SORT_THRESHOLD (size_t(1) << 16)
+#endif
+#endif
 
 namespace mystl {
 template <typename T>
@@ -76,6 +86,148 @@ class list_iterator {
     }
 };
 
+// list::sort对大链表使用的数组排序：把节点指针收集到连续数组里做稳定的
+// 自然归并排序，最后一次性重新链接。比较仍要访问节点，但归并时的读写都是
+// 顺序访问数组，不再沿着冷缓存的next指针逐个splice。
+namespace detail {
+// 有序段的最小长度，不足的用插入排序补齐
+constexpr size_t list_sort_min_run = 32;
+
+// 从a[first]开始取一个有序段，返回段尾
+// 严格降序的段就地反转，相等元素不会被交换，排序仍然稳定
+template <typename P, typename Less>
+size_t list_sort_next_run(P *a, size_t first, size_t last, Less less) {
+    size_t i = first + 1;
+    if (i == last) return last;
+    if (less(a[i], a[first])) {
+        while (i < last && less(a[i], a[i - 1])) ++i;
+        for (size_t l = first, r = i - 1; l < r; ++l, --r) {
+            P tmp = a[l];
+            a[l] = a[r];
+            a[r] = tmp;
+        }
+    } else {
+        while (i < last && !less(a[i], a[i - 1])) ++i;
+    }
+    const size_t end =
+        last - first < list_sort_min_run ? last : first + list_sort_min_run;
+    for (; i < end; ++i) {
+        P x = a[i];
+        size_t j = i;
+        for (; j > first && less(x, a[j - 1]); --j) {
+            a[j] = a[j - 1];
+        }
+        a[j] = x;
+    }
+    return i;
+}
+
+// 把[first, last)切成有序段，段尾依次写入bounds，返回段数
+template <typename P, typename Less>
+size_t list_sort_find_runs(P *a, size_t first, size_t last, size_t *bounds,
+                           Less less) {
+    size_t runs = 0;
+    while (first != last) {
+        first = list_sort_next_run(a, first, last, less);
+        bounds[runs++] = first;
+    }
+    return runs;
+}
+
+// 把src中相邻的有序段[first, mid)和[mid, last)合并到dst的同一位置
+template <typename P, typename Less>
+void list_sort_merge(const P *src, P *dst, size_t first, size_t mid,
+                     size_t last, Less less) {
+    size_t i = first, j = mid, k = first;
+    // 两段已经首尾有序时直接拷贝
+    if (mid != last && less(src[mid], src[mid - 1])) {
+        while (i < mid && j < last) {
+            dst[k++] = less(src[j], src[i]) ? src[j++] : src[i++];
+        }
+    }
+    mystl::copy(src + i, src + mid, dst + k);
+    mystl::copy(src + j, src + last, dst + k + (mid - i));
+}
+
+// 一轮归并：第k段和第k + 1段合并，bounds原地更新，返回新的段数
+template <typename P, typename Less>
+size_t list_sort_merge_round(const P *src, P *dst, size_t *bounds,
+                             size_t runs, Less less) {
+    const size_t pairs = (runs + 1) / 2;
+    auto merge_pair = [&](size_t k) {
+        const size_t first = k == 0 ? 0 : bounds[2 * k - 1];
+        const size_t mid = bounds[2 * k];
+        const size_t last = 2 * k + 1 < runs ? bounds[2 * k + 1] : mid;
+        list_sort_merge(src, dst, first, mid, last, less);
+    };
+#ifdef MYSTL_PARALLEL_SORT
+    // 每一对的合并互不相干，前几轮段数多时分给线程池
+    thread_pool &pool = thread_pool::instance();
+    if (pairs > 1 && pool.size() > 1 &&
+        bounds[runs - 1] >= MYSTL_PARALLEL_SORT_THRESHOLD) {
+        pool.run(pairs, merge_pair);
+    } else {
+        for (size_t k = 0; k < pairs; ++k) merge_pair(k);
+    }
+#else
+    for (size_t k = 0; k < pairs; ++k) merge_pair(k);
+#endif
+    for (size_t k = 0; k < pairs; ++k) {
+        bounds[k] = 2 * k + 1 < runs ? bounds[2 * k + 1] : bounds[2 * k];
+    }
+    return pairs;
+}
+
+// bounds需要的长度，并行时每个线程各用一段
+inline size_t list_sort_bounds_size(size_t n) {
+#ifdef MYSTL_PARALLEL_SORT
+    const size_t threads = thread_pool::instance().size();
+    return n / list_sort_min_run + 3 * threads + 1;
+#else
+    return n / list_sort_min_run + 1;
+#endif
+}
+
+// 对a[0, n)做稳定排序，b是同样大小的缓冲区，返回结果所在的数组
+template <typename P, typename Less>
+P *list_sort_array(P *a, P *b, size_t n, size_t *bounds, Less less) {
+    size_t runs = 0;
+#ifdef MYSTL_PARALLEL_SORT
+    thread_pool &pool = thread_pool::instance();
+    const size_t threads = pool.size();
+    if (threads > 1 && n >= MYSTL_PARALLEL_SORT_THRESHOLD) {
+        // 每个线程在自己的一块里找段，段数先记在该线程区域的第一格
+        const size_t chunk = (n + threads - 1) / threads;
+        const size_t stride = chunk / list_sort_min_run + 2;
+        pool.run(threads, [&](size_t t) {
+            const size_t first = t * chunk < n ? t * chunk : n;
+            const size_t last = n - first < chunk ? n : first + chunk;
+            size_t *out = bounds + t * stride;
+            out[0] = list_sort_find_runs(a, first, last, out + 1, less);
+        });
+        for (size_t t = 0; t < threads; ++t) {
+            const size_t *in = bounds + t * stride;
+            const size_t cnt = in[0];
+            for (size_t i = 0; i < cnt; ++i) {
+                bounds[runs++] = in[i + 1];
+            }
+        }
+    } else {
+        runs = list_sort_find_runs(a, 0, n, bounds, less);
+    }
+#else
+    runs = list_sort_find_runs(a, 0, n, bounds, less);
+#endif
+    while (runs > 1) {
+        runs = list_sort_merge_round(a, b, bounds, runs, less);
+        P *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    return a;
+}
+}  // namespace detail
+
 template <typename T, typename Alloc = mystl::simple_alloc<list_node<T>>>
 class list {
    public:
@@ -97,6 +249,7 @@ class list {
 
    protected:
     link_type node;
+    size_type count;  // 元素个数，插入删除和splice时同步维护
 
     // 辅助函数
     link_type get_node() { return Alloc::allocate(); }
@@ -109,6 +262,7 @@ class list {
         } catch (const std::exception &e) {
             put_node(p);
             std::cerr << e.what() << '\n';
+            throw;
         }
     }
     void destroy_node(link_type p) {
@@ -125,6 +279,10 @@ class list {
 
     void transfer(iterator position, iterator first, iterator last);
 
+    // 不少于这么多个元素时sort改用节点指针数组排序
+    static constexpr size_type sort_array_threshold = 256;
+    bool sort_by_array();
+
    public:
     // 构造函数
     list() { empty_init(); }  // 默认构造函数
@@ -171,9 +329,7 @@ class list {
 
     // 容器容量操作
     bool empty() const { return node->next == node; }
-    size_type size() const {
-        return static_cast<size_type>(distance(begin(), end()));
-    }
+    size_type size() const { return count; }
     size_type max_size() const { return size_type(-1) / sizeof(link_type); }
 
     // 元素访问操作
@@ -184,7 +340,10 @@ class list {
     reference operator[](size_type n) { return *(begin() + n); }
 
     // 修改链表操作
-    void swap(list<T> &rhs) { std::swap(node, rhs.node); }
+    void swap(list<T> &rhs) {
+        std::swap(node, rhs.node);
+        std::swap(count, rhs.count);
+    }
 
     void insert(iterator position, const T &x);
     void insert(iterator position, size_type n, const T &x);
@@ -204,16 +363,26 @@ class list {
     void clear();
 
     void remove(const T &value);
+    // 稳定排序，定义MYSTL_PARALLEL_SORT后大链表会并行比较，
+    // 此时T的operator<需要能被多个线程同时调用
     void sort();
     void merge(list<T> &other_list);
     void reverse();
     void unique();
-
-    // 链表移动，依靠tranfer实现
+    // 让链表顺序与节点地址顺序一致：第k个元素移到地址第k小的节点里，
+    // 顺序遍历变成按地址递增访问内存。不分配新节点，但元素会在节点间移动，
+    // 迭代器仍指向原来的节点，所指的元素随之改变
+    void linearize();
+
+    // 链表移动，依靠transfer实现
+    // 整表和单个节点的splice是O(1)；区间splice在两个链表之间移动时
+    // 需要数出区间长度，已知长度n时用带n的版本，仍是O(1)
     void splice(iterator position, list &other_list);
     void splice(iterator position, list &other_list, iterator i);
     void splice(iterator position, list &other_list, iterator first,
                 iterator last);
+    void splice(iterator position, list &other_list, iterator first,
+                iterator last, size_type n);
 
     // 比较操作
     template <typename T1, typename Alloc1>
@@ -228,6 +397,7 @@ void list<T, Alloc>::empty_init() {
     node = get_node();
     node->next = node;
     node->prev = node;
+    count = 0;
 }
 
 template <typename T, typename Alloc>
@@ -284,12 +454,14 @@ list<T> &list<T, Alloc>::operator=(const list<T> &rhs) {
         clear();
         insert(begin(), rhs.begin(), rhs.end());
     }
+    return *this;
 }
 
 template <typename T, typename Alloc>
 list<T> &list<T, Alloc>::operator=(std::initializer_list<T> il) {
     clear();
     insert(begin(), il.begin(), il.end());
+    return *this;
 }
 
 template <typename T, typename Alloc>
@@ -299,6 +471,7 @@ void list<T, Alloc>::insert(iterator position, const T &x) {
     tmp->prev = position.node->prev;
     position.node->prev->next = tmp;
     position.node->prev = tmp;
+    ++count;
 }
 
 template <typename T, typename Alloc>
@@ -320,10 +493,12 @@ void list<T, Alloc>::insert(iterator position, InputIterator first,
 template <typename T, typename Alloc>
 typename list<T, Alloc>::iterator list<T, Alloc>::erase(iterator position) {
     link_type tmp = position.node;
-    position.node->prev->next = position.node->next;
-    position.node->next->prev = position.node->prev;
+    link_type next = tmp->next;
+    tmp->prev->next = next;
+    next->prev = tmp->prev;
     destroy_node(tmp);
-    return position;
+    --count;
+    return iterator(next);
 }
 
 template <typename T, typename Alloc>
@@ -381,34 +556,148 @@ void list<T, Alloc>::remove(const T &value) {
     iterator last = end();
     while (first != last) {
         if (*first == value) {
-            erase(first);
+            first = erase(first);
         } else {
             ++first;
         }
     }
 }
 
+// 已经有序时只扫描一遍；大链表先尝试数组排序，申请不到缓冲区时退回到
+// 原地的64路归并
 template <typename T, typename Alloc>
 void list<T, Alloc>::sort() {
-    if (empty() || size() == 1) return;
+    if (size() <= 1) return;
+
+    link_type p = node->next;
+    while (p->next != node && !(p->next->data < p->data)) {
+        p = p->next;
+    }
+    if (p->next == node) return;
+
+    if (size() >= sort_array_threshold && sort_by_array()) return;
 
-    list<T, Alloc> tmp;
-    list<T, Alloc> count[64];
+    list<T, Alloc> carry;
+    list<T, Alloc> counter[64];
     int fill = 0;
     while (!empty()) {
-        tmp.splice(tmp.begin(), *this, begin());
+        carry.splice(carry.begin(), *this, begin());
         int i = 0;
-        while (i < fill && !count[i].empty()) {
-            count[i].merge(tmp);
-            tmp.swap(count[i++]);
+        while (i < fill && !counter[i].empty()) {
+            counter[i].merge(carry);
+            carry.swap(counter[i++]);
         }
-        tmp.swap(count[i]);
+        carry.swap(counter[i]);
         if (i == fill) ++fill;
     }
     for (int i = 1; i < fill; ++i) {
-        count[i].merge(count[i - 1]);
+        counter[i].merge(counter[i - 1]);
     }
-    swap(*this, count[fill - 1]);
+    swap(counter[fill - 1]);
+}
+
+// 节点指针排好序后按数组顺序重新链接，比较抛出异常时链表保持不变
+template <typename T, typename Alloc>
+bool list<T, Alloc>::sort_by_array() {
+    using ptr_alloc = typename Alloc::template rebind<link_type>::other;
+    using bound_alloc = typename Alloc::template rebind<size_t>::other;
+
+    const size_type n = size();
+    const size_type bn = detail::list_sort_bounds_size(n);
+    link_type *a = nullptr;
+    link_type *b = nullptr;
+    size_t *bounds = nullptr;
+    try {
+        a = ptr_alloc::allocate(n);
+        b = ptr_alloc::allocate(n);
+        bounds = bound_alloc::allocate(bn);
+    } catch (const std::bad_alloc &) {
+        ptr_alloc::deallocate(a, n);
+        ptr_alloc::deallocate(b, n);
+        return false;
+    }
+
+    link_type p = node->next;
+    for (size_type i = 0; i < n; ++i, p = p->next) {
+        a[i] = p;
+    }
+    link_type *sorted;
+    try {
+        sorted = detail::list_sort_array(
+            a, b, n, bounds,
+            [](link_type x, link_type y) { return x->data < y->data; });
+    } catch (const std::exception &e) {
+        ptr_alloc::deallocate(a, n);
+        ptr_alloc::deallocate(b, n);
+        bound_alloc::deallocate(bounds, bn);
+        throw;
+    }
+
+    link_type prev = node;
+    for (size_type i = 0; i < n; ++i) {
+        prev->next = sorted[i];
+        sorted[i]->prev = prev;
+        prev = sorted[i];
+    }
+    prev->next = node;
+    node->prev = prev;
+
+    ptr_alloc::deallocate(a, n);
+    ptr_alloc::deallocate(b, n);
+    bound_alloc::deallocate(bounds, bn);
+    return true;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::linearize() {
+    using ptr_alloc = typename Alloc::template rebind<link_type>::other;
+    using index_alloc = typename Alloc::template rebind<size_t>::other;
+
+    const size_type n = size();
+    if (n <= 1) return;
+    const size_type bn = detail::list_sort_bounds_size(n);
+    link_type *nodes = ptr_alloc::allocate(n);
+    size_t *a = index_alloc::allocate(n);
+    size_t *b = index_alloc::allocate(n);
+    size_t *bounds = index_alloc::allocate(bn);
+
+    link_type p = node->next;
+    for (size_type i = 0; i < n; ++i, p = p->next) {
+        nodes[i] = p;
+        a[i] = i;
+    }
+    // order[k]是地址第k小的节点在链表中的序号
+    size_t *order = detail::list_sort_array(
+        a, b, n, bounds, [nodes](size_t x, size_t y) {
+            return std::less<link_type>()(nodes[x], nodes[y]);
+        });
+
+    link_type prev = node;
+    for (size_type k = 0; k < n; ++k) {
+        link_type cur = nodes[order[k]];
+        prev->next = cur;
+        cur->prev = prev;
+        prev = cur;
+    }
+    prev->next = node;
+    node->prev = prev;
+
+    // 第k个元素放进nodes[order[k]]，按置换的环依次交换，处理过的位置记为自身
+    for (size_type k = 0; k < n; ++k) {
+        size_t j = order[k];
+        while (j != k) {
+            mystl::swap(nodes[k]->data, nodes[j]->data);
+            const size_t next = order[j];
+            order[j] = j;
+            j = next;
+        }
+        order[k] = k;
+    }
+
+    ptr_alloc::deallocate(nodes, n);
+    index_alloc::deallocate(a, n);
+    index_alloc::deallocate(b, n);
+    index_alloc::deallocate(bounds, bn);
 }
 
 // 默认有序
@@ -434,28 +723,29 @@ void list<T, Alloc>::merge(list<T> &other_list) {
 
 template <typename T, typename Alloc>
 void list<T, Alloc>::reverse() {
-    if (empty() || size() == 1) return;
+    if (size() <= 1) return;
 
     iterator first = begin();
     ++first;
     while (first != end()) {
         iterator old = first;
         ++first;
-        tranfer(begin(), old, first);
+        transfer(begin(), old, first);
     }
 }
 
 // 已经默认有序
 template <typename T, typename Alloc>
 void list<T, Alloc>::unique() {
-    if (empty() || size() == 1) return;
+    if (size() <= 1) return;
 
     iterator first = begin();
     iterator last = end();
     iterator next = first;
     while (++next != last) {
         if (*first == *next) {
-            first = erase(first);
+            erase(next);
+            next = first;
         } else {
             first = next;
         }
@@ -467,6 +757,8 @@ template <typename T, typename Alloc>
 void list<T, Alloc>::splice(iterator position, list &other_list) {
     if (!other_list.empty()) {
         transfer(position, other_list.begin(), other_list.end());
+        count += other_list.count;
+        other_list.count = 0;
     }
 }
 
@@ -476,12 +768,31 @@ void list<T, Alloc>::splice(iterator position, list &other_list, iterator i) {
     ++j;
     if (position == i || position == j) return;
     transfer(position, i, j);
+    ++count;
+    --other_list.count;
 }
 
+// 同一个链表内移动时元素个数不变，不需要数区间长度
 template <typename T, typename Alloc>
 void list<T, Alloc>::splice(iterator position, list &other_list, iterator first,
                             iterator last) {
-    if (first != last) transfer(position, first, last);
+    if (first == last) return;
+    if (&other_list != this) {
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        count += n;
+        other_list.count -= n;
+    }
+    transfer(position, first, last);
+}
+
+// n必须等于distance(first, last)
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(iterator position, list &other_list, iterator first,
+                            iterator last, size_type n) {
+    if (first == last) return;
+    count += n;
+    other_list.count -= n;
+    transfer(position, first, last);
 }
 
 template <typename T, typename Alloc>
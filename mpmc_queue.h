@@ -0,0 +1,292 @@
+#pragma once
+
+// 有界多生产者多消费者队列(Vyukov)，入队出队各一次CAS，不加锁
+// 每个槽位带一个序号：seq == pos表示空闲可写，seq == pos + 1表示已写入可读，
+// 读完后置为pos + capacity，留给下一圈的写者。生产者之间只争用enqueue_pos，
+// 消费者之间只争用dequeue_pos，两者分处不同缓存行。
+// try_push/try_pop不阻塞，满或空时返回false；push/pop先自旋，仍不成功时：
+//   Blocking为true：在条件变量上睡眠，对方只在确有线程等待时才去唤醒，
+//                   无人等待时快速路径不碰互斥量；
+//   Blocking为false：让出CPU后重试，适合线程数不超过核数、始终繁忙的场景。
+// 元素先在槽位外构造好再移动进去，要求移动构造不抛出异常，
+// 否则槽位已被占用却无法写入，会卡住后面的消费者。
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "util.h"
+
+namespace mystl {
+namespace detail {
+template <typename T>
+struct mpmc_cell {
+    std::atomic<size_t> seq;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *ptr() { return std::launder(reinterpret_cast<T *>(storage)); }
+};
+}  // namespace detail
+
+template <typename T, bool Blocking = true,
+          typename Alloc = mystl::allocator<detail::mpmc_cell<T>>>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "mpmc_queue requires a nothrow move constructible type");
+
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+
+    // 阻塞前自旋尝试的次数
+    static constexpr int spin_count = 64;
+
+   protected:
+    using cell = detail::mpmc_cell<T>;
+
+    // 构造后只读
+    cell *cells;
+    size_type mask;
+    // 生产者写
+    alignas(cache_line_size) std::atomic<size_type> enqueue_pos;
+    // 消费者写
+    alignas(cache_line_size) std::atomic<size_type> dequeue_pos;
+    // 等待层，只有阻塞的线程才会碰到
+    alignas(cache_line_size) std::atomic<unsigned> waiting_consumers;
+    std::atomic<unsigned> waiting_producers;
+    std::mutex wait_mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    static size_type round_up_pow2(size_type n) {
+        size_type r = 2;
+        while (r < n) r <<= 1;
+        return r;
+    }
+
+    // 取得一个可写槽位，满时返回nullptr
+    cell *claim_push(size_type &pos);
+    // 取得一个可读槽位，空时返回nullptr
+    cell *claim_pop(size_type &pos);
+
+    // 若有线程在cv上等待，唤醒其中一个
+    void wake(std::atomic<unsigned> &waiting, std::condition_variable &cv) {
+        if (!Blocking) return;
+        // 与等待方的计数和重试构成Dekker式的握手：
+        // 要么等待方看到新状态，要么这里看到等待计数
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) != 0) {
+            { std::lock_guard<std::mutex> lock(wait_mutex); }
+            cv.notify_one();
+        }
+    }
+
+    template <typename Try>
+    void wait_until(Try try_once, std::atomic<unsigned> &waiting,
+                    std::condition_variable &cv);
+
+   public:
+    // 构造函数，capacity向上取到2的幂
+    explicit mpmc_queue(size_type capacity = 1024);
+    mpmc_queue(const mpmc_queue &) = delete;
+    mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+    // 析构函数，不能与其他操作并发
+    ~mpmc_queue();
+
+    // 容量，并发时size()只是某一时刻的近似值
+    size_type capacity() const { return mask + 1; }
+    size_type size() const {
+        const size_type d = dequeue_pos.load(std::memory_order_acquire);
+        const size_type e = enqueue_pos.load(std::memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    // 非阻塞接口
+    template <typename... Args>
+    bool try_emplace(Args &&...args);
+    bool try_push(const value_type &value) { return try_emplace(value); }
+    bool try_push(value_type &&value) {
+        return try_emplace(mystl::move(value));
+    }
+    bool try_pop(value_type &value);
+
+    // 阻塞接口，队列满或空时等待
+    template <typename... Args>
+    void emplace(Args &&...args);
+    void push(const value_type &value) { emplace(value); }
+    void push(value_type &&value) { emplace(mystl::move(value)); }
+    void pop(value_type &value);
+    value_type pop() {
+        value_type value;
+        pop(value);
+        return value;
+    }
+};
+
+template <typename T, bool Blocking, typename Alloc>
+mpmc_queue<T, Blocking, Alloc>::mpmc_queue(size_type capacity)
+    : cells(nullptr),
+      mask(round_up_pow2(capacity) - 1),
+      enqueue_pos(0),
+      dequeue_pos(0),
+      waiting_consumers(0),
+      waiting_producers(0) {
+    cells = allocator_type::allocate(mask + 1);
+    for (size_type i = 0; i <= mask; ++i) {
+        ::new (static_cast<void *>(cells + i)) cell;
+        cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, bool Blocking, typename Alloc>
+mpmc_queue<T, Blocking, Alloc>::~mpmc_queue() {
+    const size_type e = enqueue_pos.load(std::memory_order_relaxed);
+    for (size_type d = dequeue_pos.load(std::memory_order_relaxed); d != e;
+         ++d) {
+        mystl::destroy(cells[d & mask].ptr());
+    }
+    for (size_type i = 0; i <= mask; ++i) {
+        cells[i].~cell();
+    }
+    allocator_type::deallocate(cells, mask + 1);
+}
+
+template <typename T, bool Blocking, typename Alloc>
+typename mpmc_queue<T, Blocking, Alloc>::cell *
+mpmc_queue<T, Blocking, Alloc>::claim_push(size_type &pos) {
+    pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell *c = cells + (pos & mask);
+        const size_type seq = c->seq.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed)) {
+                return c;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T, bool Blocking, typename Alloc>
+typename mpmc_queue<T, Blocking, Alloc>::cell *
+mpmc_queue<T, Blocking, Alloc>::claim_pop(size_type &pos) {
+    pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell *c = cells + (pos & mask);
+        const size_type seq = c->seq.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed)) {
+                return c;
+            }
+        } else if (diff < 0) {
+            return nullptr;
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T, bool Blocking, typename Alloc>
+template <typename... Args>
+bool mpmc_queue<T, Blocking, Alloc>::try_emplace(Args &&...args) {
+    value_type value(mystl::forward<Args>(args)...);
+    size_type pos;
+    cell *c = claim_push(pos);
+    if (c == nullptr) return false;
+    mystl::construct(c->ptr(), mystl::move(value));
+    c->seq.store(pos + 1, std::memory_order_release);
+    wake(waiting_consumers, not_empty);
+    return true;
+}
+
+template <typename T, bool Blocking, typename Alloc>
+bool mpmc_queue<T, Blocking, Alloc>::try_pop(value_type &value) {
+    size_type pos;
+    cell *c = claim_pop(pos);
+    if (c == nullptr) return false;
+    value = mystl::move(*c->ptr());
+    mystl::destroy(c->ptr());
+    c->seq.store(pos + mask + 1, std::memory_order_release);
+    wake(waiting_producers, not_full);
+    return true;
+}
+
+// 先自旋，再按Blocking睡眠或让出CPU，直到try_once成功
+template <typename T, bool Blocking, typename Alloc>
+template <typename Try>
+void mpmc_queue<T, Blocking, Alloc>::wait_until(Try try_once,
+                                                std::atomic<unsigned> &waiting,
+                                                std::condition_variable &cv) {
+    for (int i = 0; i < spin_count; ++i) {
+        if (try_once()) return;
+    }
+    if (!Blocking) {
+        while (!try_once()) {
+            std::this_thread::yield();
+        }
+        return;
+    }
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::unique_lock<std::mutex> lock(wait_mutex);
+    while (!try_once()) {
+        cv.wait(lock);
+    }
+    waiting.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename T, bool Blocking, typename Alloc>
+template <typename... Args>
+void mpmc_queue<T, Blocking, Alloc>::emplace(Args &&...args) {
+    value_type value(mystl::forward<Args>(args)...);
+    wait_until(
+        [&] {
+            size_type pos;
+            cell *c = claim_push(pos);
+            if (c == nullptr) return false;
+            mystl::construct(c->ptr(), mystl::move(value));
+            c->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        },
+        waiting_producers, not_full);
+    wake(waiting_consumers, not_empty);
+}
+
+template <typename T, bool Blocking, typename Alloc>
+void mpmc_queue<T, Blocking, Alloc>::pop(value_type &value) {
+    wait_until(
+        [&] {
+            size_type pos;
+            cell *c = claim_pop(pos);
+            if (c == nullptr) return false;
+            value = mystl::move(*c->ptr());
+            mystl::destroy(c->ptr());
+            c->seq.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        },
+        waiting_consumers, not_empty);
+    wake(waiting_producers, not_full);
+}
+}  // namespace mystl
@@ -1,22 +1,41 @@
 #pragma once
 
+#include "./algobase.h"
 #include "./alloc.h"
 #include "./allocator.h"
+#include "./circular_buffer.h"
+#include "./concurrent_skip_list.h"
+#include "./concurrent_vector.h"
 #include "./construct.h"
 #include "./deque.h"
 #include "./deque_iterator.h"
+#include "./dynamic_bitset.h"
+#include "./forward_list.h"
 #include "./functional.h"
 #include "./heap.h"
+#include "./intrusive_list.h"
 #include "./iterator.h"
 #include "./list.h"
 #include "./map.h"
+#include "./mpmc_queue.h"
+#include "./parallel.h"
+#include "./persistent_vector.h"
+#include "./prefetch.h"
 #include "./priority_queue.h"
 #include "./queue.h"
 #include "./rb_tree.h"
 #include "./rb_tree_algorithm.h"
 #include "./rb_tree_color.h"
+#include "./simd.h"
+#include "./soa_vector.h"
+#include "./spsc_queue.h"
 #include "./stack.h"
+#include "./static_vector.h"
+#include "./timer_wheel.h"
 #include "./type_traits.h"
 #include "./uninitialized.h"
+#include "./unrolled_list.h"
 #include "./util.h"
-#include "./vector.h"
\ No newline at end of file
+#include "./vector.h"
+#include "./vector_io.h"
+#include "./work_stealing_deque.h"
\ No newline at end of file
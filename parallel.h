@@ -0,0 +1,237 @@
+#pragma once
+
+// 大块平凡类型缓冲区的并行初始化
+// 定义MYSTL_PARALLEL_INIT后启用：超过MYSTL_PARALLEL_INIT_THRESHOLD字节的
+// 填充和拷贝按页对齐切分给常驻线程池，第i段始终由第i个工作线程首次写入，
+// 页面因此分布在之后使用它们的线程所在的NUMA节点上。
+// 未定义时以下接口等价于对应的uninitialized_*，不引入线程依赖。
+// 线程池也供MYSTL_PARALLEL_SORT(list::sort并行排序)使用。
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "uninitialized.h"
+
+#if defined(MYSTL_PARALLEL_INIT) || defined(MYSTL_PARALLEL_SORT)
+#define MYSTL_THREAD_POOL
+#endif
+
+#ifdef MYSTL_THREAD_POOL
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
+#if defined(MYSTL_PARALLEL_INIT) && !defined(MYSTL_PARALLEL_INIT_THRESHOLD)
+#define MYSTL_PARALLEL_INIT_THRESHOLD (size_t(1) << 24)
+#endif
+
+namespace mystl {
+#ifdef MYSTL_THREAD_POOL
+// 常驻线程池，任务i固定交给第i % size()个工作线程
+class thread_pool {
+   public:
+    static thread_pool &instance() {
+        static thread_pool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
+
+    size_t size() const { return worker_count; }
+
+    // 执行fn(0) ... fn(n - 1)，全部完成后返回。
+    // 任务抛出异常后其余尚未开始的任务被跳过，等所有工作线程停下后，
+    // 第一个异常在调用线程重新抛出。
+    // 在工作线程里嵌套调用时直接在当前线程依次执行，否则会等待自己而死锁
+    void run(size_t n, const std::function<void(size_t)> &fn) {
+        if (current_pool() == this) {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(run_mutex);
+        std::exception_ptr failure;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            job = &fn;
+            task_count = n;
+            pending = worker_count;
+            failed.store(false, std::memory_order_relaxed);
+            ++generation;
+            start_cv.notify_all();
+            done_cv.wait(lock, [this] { return pending == 0; });
+            job = nullptr;
+            failure = error;
+            error = nullptr;
+        }
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers[i].join();
+        }
+        delete[] workers;
+    }
+
+   private:
+    explicit thread_pool(size_t n)
+        : worker_count(n == 0 ? 1 : n),
+          workers(nullptr),
+          job(nullptr),
+          task_count(0),
+          pending(0),
+          generation(0),
+          failed(false),
+          stop(false) {
+        workers = new std::thread[worker_count];
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers[i] = std::thread([this, i] { work(i); });
+        }
+    }
+
+    // 当前线程所属的线程池，不是工作线程时为nullptr
+    static thread_pool *&current_pool() {
+        static thread_local thread_pool *pool = nullptr;
+        return pool;
+    }
+
+    void work(size_t id) {
+        current_pool() = this;
+        size_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)> *fn;
+            size_t n;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start_cv.wait(lock,
+                              [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+                fn = job;
+                n = task_count;
+            }
+            try {
+                for (size_t i = id; i < n; i += worker_count) {
+                    if (failed.load(std::memory_order_relaxed)) break;
+                    (*fn)(i);
+                }
+            } catch (...) {
+                failed.store(true, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) done_cv.notify_one();
+        }
+    }
+
+    size_t worker_count;
+    std::thread *workers;
+
+    std::mutex run_mutex;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    const std::function<void(size_t)> *job;
+    size_t task_count;
+    size_t pending;
+    size_t generation;
+    std::exception_ptr error;  // 本轮第一个任务异常
+    std::atomic<bool> failed;
+    bool stop;
+};
+#endif
+
+#ifdef MYSTL_PARALLEL_INIT
+// 把base[0, n)切成每个线程一段。段边界按元素地址对齐到4096字节页，
+// 相邻线程不会首次写入同一页(元素大小不整除页时，跨页的那个元素除外)
+template <typename T, typename Func>
+void parallel_for_pages(const T *base, size_t n, Func fn) {
+    thread_pool &pool = thread_pool::instance();
+    const size_t threads = pool.size();
+    const size_t chunk = (n + threads - 1) / threads;
+    const uintptr_t origin = reinterpret_cast<uintptr_t>(base);
+    // 第i段的起点：名义起点所在地址向上取整到页边界，再换回下标
+    auto bound = [&](size_t i) -> size_t {
+        if (i == 0) return 0;
+        if (i >= threads || i * chunk >= n) return n;
+        const uintptr_t addr = origin + i * chunk * sizeof(T);
+        const uintptr_t aligned = (addr + 4095) & ~uintptr_t(4095);
+        const size_t index = (aligned - origin + sizeof(T) - 1) / sizeof(T);
+        return index < n ? index : n;
+    };
+    pool.run(threads, [&](size_t i) {
+        const size_t first = bound(i);
+        const size_t last = bound(i + 1);
+        if (first < last) fn(first, last);
+    });
+}
+
+template <typename T>
+bool use_parallel_init(size_t n) {
+    return std::is_trivially_copyable<T>::value &&
+           n * sizeof(T) >= MYSTL_PARALLEL_INIT_THRESHOLD &&
+           thread_pool::instance().size() > 1;
+}
+#endif
+
+// parallel_uninitialized_fill_n
+template <typename T>
+T *parallel_uninitialized_fill_n(T *first, size_t n, const T &value) {
+#ifdef MYSTL_PARALLEL_INIT
+    if (use_parallel_init<T>(n)) {
+        parallel_for_pages(first, n, [&](size_t b, size_t e) {
+            mystl::uninitialized_fill_n(first + b, e - b, value);
+        });
+        return first + n;
+    }
+#endif
+    return mystl::uninitialized_fill_n(first, n, value);
+}
+
+// parallel_uninitialized_copy
+// 只有源区间也是连续内存(指针)时才能并行
+template <typename InputIterator, typename T>
+T *parallel_uninitialized_copy(InputIterator first, InputIterator last,
+                               T *result, mystl::false_type) {
+    return mystl::uninitialized_copy(first, last, result);
+}
+
+template <typename InputIterator, typename T>
+T *parallel_uninitialized_copy(InputIterator first, InputIterator last,
+                               T *result, mystl::true_type) {
+#ifdef MYSTL_PARALLEL_INIT
+    const size_t n = static_cast<size_t>(last - first);
+    if (use_parallel_init<T>(n)) {
+        parallel_for_pages(result, n, [&](size_t b, size_t e) {
+            mystl::uninitialized_copy(first + b, first + e, result + b);
+        });
+        return result + n;
+    }
+#endif
+    return mystl::uninitialized_copy(first, last, result);
+}
+
+template <typename InputIterator, typename T>
+T *parallel_uninitialized_copy(InputIterator first, InputIterator last,
+                               T *result) {
+    using source_type = typename std::remove_cv<
+        typename std::remove_pointer<InputIterator>::type>::type;
+    using is_contiguous = mystl::integral_constant<
+        bool, std::is_pointer<InputIterator>::value &&
+                  std::is_same<source_type, T>::value>;
+    return mystl::parallel_uninitialized_copy(first, last, result,
+                                              is_contiguous());
+}
+}  // namespace mystl
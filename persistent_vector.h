@@ -0,0 +1,640 @@
+#pragma once
+
+// 持久化(不可变)向量，32叉前缀树 + 尾部缓冲
+// push_back/set/pop_back不修改原对象，而是返回新版本，新旧版本共享未改动的节点：
+// 拷贝(快照)为O(1)，更新只复制根到目标叶子的一条路径，O(log32 n)。
+// 节点引用计数是原子的，不同线程可以各自持有、读取和更新同一数据的不同版本，
+// 同一个persistent_vector对象本身不能被多个线程同时修改。
+// 最后不超过32个元素放在尾部叶子中，追加通常只复制这一个叶子；
+// 独占的节点(引用计数为1)原地修改，从临时对象连续追加时不会产生多余的复制。
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "allocator.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "uninitialized.h"
+
+namespace mystl {
+template <typename T, typename Alloc = mystl::allocator<T>>
+class persistent_vector {
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = const T &;
+    using const_reference = const T &;
+    using pointer = const T *;
+    using const_pointer = const T *;
+
+    static constexpr size_type bits = 5;
+    static constexpr size_type width = size_type(1) << bits;
+    static constexpr size_type mask = width - 1;
+
+   protected:
+    struct node {
+        std::atomic<size_type> refs;
+        node() : refs(1) {}
+    };
+    struct branch_node : node {
+        node *child[width];
+        branch_node() {
+            for (size_type i = 0; i < width; ++i) child[i] = nullptr;
+        }
+    };
+    struct leaf_node : node {
+        size_type count;
+        alignas(T) unsigned char storage[sizeof(T) * width];
+        leaf_node() : count(0) {}
+        T *data() { return std::launder(reinterpret_cast<T *>(storage)); }
+        const T *data() const {
+            return std::launder(reinterpret_cast<const T *>(storage));
+        }
+    };
+
+    using branch_allocator =
+        typename Alloc::template rebind<branch_node>::other;
+    using leaf_allocator = typename Alloc::template rebind<leaf_node>::other;
+
+    branch_node *root;  // 树中没有元素时为空，叶子层的位移为0
+    leaf_node *tail;    // 最后1到width个元素，空向量时为空
+    size_type count;
+    size_type shift;  // 根节点的位移
+
+   public:
+    // 只读随机访问迭代器，缓存当前所在叶子
+    class const_iterator {
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : owner(nullptr), index(0), block(nullptr), base(0) {}
+        const_iterator(const persistent_vector *owner, size_type index)
+            : owner(owner), index(index), block(nullptr), base(0) {}
+
+        reference operator*() const {
+            if (block == nullptr || index - base >= width) {
+                base = index & ~mask;
+                block = owner->leaf_for(index)->data();
+            }
+            return block[index - base];
+        }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        const_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++index;
+            return tmp;
+        }
+        const_iterator &operator--() {
+            --index;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator tmp = *this;
+            --index;
+            return tmp;
+        }
+        const_iterator &operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const {
+            const_iterator tmp = *this;
+            return tmp += n;
+        }
+        const_iterator operator-(difference_type n) const {
+            const_iterator tmp = *this;
+            return tmp -= n;
+        }
+        difference_type operator-(const const_iterator &rhs) const {
+            return static_cast<difference_type>(index) -
+                   static_cast<difference_type>(rhs.index);
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return index == rhs.index;
+        }
+        bool operator!=(const const_iterator &rhs) const {
+            return index != rhs.index;
+        }
+        bool operator<(const const_iterator &rhs) const {
+            return index < rhs.index;
+        }
+
+       private:
+        const persistent_vector *owner;
+        size_type index;
+        mutable const T *block;
+        mutable size_type base;
+    };
+
+    using iterator = const_iterator;
+
+   protected:
+    // 引用计数
+    static void retain(node *p) {
+        p->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    static bool unique(const node *p) {
+        return p->refs.load(std::memory_order_acquire) == 1;
+    }
+    static void release_leaf(leaf_node *p);
+    static void release_branch(branch_node *p, size_type level);
+
+    // 节点分配与复制
+    static leaf_node *new_leaf();
+    static branch_node *new_branch();
+    static leaf_node *clone_leaf(const leaf_node *src, size_type n);
+    static branch_node *clone_branch(const branch_node *src);
+    static branch_node *writable(branch_node *p) {
+        return unique(p) ? p : clone_branch(p);
+    }
+
+    size_type tail_offset() const {
+        return count == 0 ? 0 : (count - 1) & ~mask;
+    }
+    const leaf_node *leaf_for(size_type n) const;
+
+    // 以下函数原地修改*this，共享的节点先复制；抛出异常时*this不变
+    template <typename... Args>
+    void append(Args &&...args);
+    void assign(size_type n, const value_type &value);
+    void remove_last();
+
+    void push_tail();
+    branch_node *push_tail(size_type level, branch_node *parent);
+    branch_node *new_path(size_type level, leaf_node *leaf);
+    branch_node *assign_path(size_type level, branch_node *parent,
+                             size_type n, const value_type &value);
+    branch_node *pop_tail(size_type level, branch_node *parent);
+
+   public:
+    // 构造函数
+    persistent_vector()
+        : root(nullptr), tail(nullptr), count(0), shift(bits) {}
+    persistent_vector(size_type n, const value_type &value)
+        : persistent_vector() {
+        for (size_type i = 0; i < n; ++i) append(value);
+    }
+    persistent_vector(std::initializer_list<value_type> il)
+        : persistent_vector() {
+        for (const value_type &value : il) append(value);
+    }
+    template <typename InputIterator,
+              typename = decltype(*std::declval<InputIterator &>(),
+                                  ++std::declval<InputIterator &>())>
+    persistent_vector(InputIterator first, InputIterator last)
+        : persistent_vector() {
+        for (; first != last; ++first) append(*first);
+    }
+
+    // 拷贝即快照，只增加根和尾部的引用计数
+    persistent_vector(const persistent_vector &rhs)
+        : root(rhs.root), tail(rhs.tail), count(rhs.count), shift(rhs.shift) {
+        if (root != nullptr) retain(root);
+        if (tail != nullptr) retain(tail);
+    }
+    persistent_vector(persistent_vector &&rhs) : persistent_vector() {
+        swap(rhs);
+    }
+    persistent_vector &operator=(const persistent_vector &rhs) {
+        persistent_vector tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+    persistent_vector &operator=(persistent_vector &&rhs) {
+        persistent_vector tmp(std::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    // 析构函数
+    ~persistent_vector() {
+        release_branch(root, shift);
+        release_leaf(tail);
+    }
+
+    // 迭代器
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    // 容量
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // 访问
+    const_reference operator[](size_type n) const {
+        return leaf_for(n)->data()[n & mask];
+    }
+    const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "persistent_vector<T>::at");
+        return (*this)[n];
+    }
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return tail->data()[tail->count - 1]; }
+
+    // 更新，返回新版本，*this不变
+    persistent_vector push_back(const value_type &value) const {
+        persistent_vector tmp(*this);
+        tmp.append(value);
+        return tmp;
+    }
+    persistent_vector push_back(value_type &&value) const {
+        persistent_vector tmp(*this);
+        tmp.append(std::move(value));
+        return tmp;
+    }
+    template <typename... Args>
+    persistent_vector emplace_back(Args &&...args) const {
+        persistent_vector tmp(*this);
+        tmp.append(std::forward<Args>(args)...);
+        return tmp;
+    }
+    persistent_vector set(size_type n, const value_type &value) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "persistent_vector<T>::set");
+        persistent_vector tmp(*this);
+        tmp.assign(n, value);
+        return tmp;
+    }
+    persistent_vector pop_back() const {
+        MYSTL_DEBUG(count != 0);
+        persistent_vector tmp(*this);
+        tmp.remove_last();
+        return tmp;
+    }
+
+    void swap(persistent_vector &rhs) {
+        std::swap(root, rhs.root);
+        std::swap(tail, rhs.tail);
+        std::swap(count, rhs.count);
+        std::swap(shift, rhs.shift);
+    }
+};
+
+template <typename T, typename Alloc>
+void persistent_vector<T, Alloc>::release_leaf(leaf_node *p) {
+    if (p == nullptr || p->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    mystl::destroy(p->data(), p->data() + p->count);
+    p->~leaf_node();
+    leaf_allocator::deallocate(p);
+}
+
+template <typename T, typename Alloc>
+void persistent_vector<T, Alloc>::release_branch(branch_node *p,
+                                                 size_type level) {
+    if (p == nullptr || p->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    for (size_type i = 0; i < width && p->child[i] != nullptr; ++i) {
+        if (level == bits) {
+            release_leaf(static_cast<leaf_node *>(p->child[i]));
+        } else {
+            release_branch(static_cast<branch_node *>(p->child[i]),
+                           level - bits);
+        }
+    }
+    p->~branch_node();
+    branch_allocator::deallocate(p);
+}
+
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::leaf_node *
+persistent_vector<T, Alloc>::new_leaf() {
+    leaf_node *p = leaf_allocator::allocate();
+    return ::new (static_cast<void *>(p)) leaf_node();
+}
+
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::new_branch() {
+    branch_node *p = branch_allocator::allocate();
+    return ::new (static_cast<void *>(p)) branch_node();
+}
+
+// 复制src的前n个元素
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::leaf_node *
+persistent_vector<T, Alloc>::clone_leaf(const leaf_node *src, size_type n) {
+    leaf_node *p = new_leaf();
+    try {
+        mystl::uninitialized_copy(src->data(), src->data() + n, p->data());
+    } catch (...) {
+        release_leaf(p);
+        throw;
+    }
+    p->count = n;
+    return p;
+}
+
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::clone_branch(const branch_node *src) {
+    branch_node *p = new_branch();
+    for (size_type i = 0; i < width && src->child[i] != nullptr; ++i) {
+        p->child[i] = src->child[i];
+        retain(p->child[i]);
+    }
+    return p;
+}
+
+template <typename T, typename Alloc>
+const typename persistent_vector<T, Alloc>::leaf_node *
+persistent_vector<T, Alloc>::leaf_for(size_type n) const {
+    if (n >= tail_offset()) return tail;
+    const node *p = root;
+    for (size_type level = shift; level > 0; level -= bits) {
+        p = static_cast<const branch_node *>(p)->child[(n >> level) & mask];
+    }
+    return static_cast<const leaf_node *>(p);
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+void persistent_vector<T, Alloc>::append(Args &&...args) {
+    // 尾部已满：新元素放入新的尾部叶子，旧尾部并入树中
+    if (tail != nullptr && tail->count == width) {
+        leaf_node *fresh = new_leaf();
+        try {
+            mystl::construct(fresh->data(), std::forward<Args>(args)...);
+            fresh->count = 1;
+            push_tail();
+        } catch (...) {
+            release_leaf(fresh);
+            throw;
+        }
+        tail = fresh;
+        ++count;
+        return;
+    }
+    leaf_node *t = tail;
+    if (t == nullptr) {
+        t = new_leaf();
+    } else if (!unique(t)) {
+        t = clone_leaf(t, t->count);
+    }
+    try {
+        mystl::construct(t->data() + t->count, std::forward<Args>(args)...);
+    } catch (...) {
+        if (t != tail) release_leaf(t);
+        throw;
+    }
+    ++t->count;
+    if (t != tail) {
+        release_leaf(tail);
+        tail = t;
+    }
+    ++count;
+}
+
+// 把已满的尾部叶子并入树中，尾部的引用转移给树
+template <typename T, typename Alloc>
+void persistent_vector<T, Alloc>::push_tail() {
+    if (root == nullptr) {
+        root = new_branch();
+        root->child[0] = tail;
+        shift = bits;
+    } else if ((count >> bits) > (size_type(1) << shift)) {
+        // 根已满，树增高一层
+        branch_node *new_root = new_branch();
+        try {
+            new_root->child[1] = new_path(shift, tail);
+        } catch (...) {
+            release_branch(new_root, shift + bits);
+            throw;
+        }
+        new_root->child[0] = root;
+        root = new_root;
+        shift += bits;
+    } else {
+        branch_node *new_root = push_tail(shift, root);
+        if (new_root != root) {
+            release_branch(root, shift);
+            root = new_root;
+        }
+    }
+}
+
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::push_tail(size_type level, branch_node *parent) {
+    branch_node *b = writable(parent);
+    const size_type sub = ((count - 1) >> level) & mask;
+    try {
+        if (level == bits) {
+            b->child[sub] = tail;
+        } else if (b->child[sub] != nullptr) {
+            branch_node *c = static_cast<branch_node *>(b->child[sub]);
+            branch_node *nc = push_tail(level - bits, c);
+            if (nc != c) {
+                release_branch(c, level - bits);
+                b->child[sub] = nc;
+            }
+        } else {
+            b->child[sub] = new_path(level - bits, tail);
+        }
+    } catch (...) {
+        if (b != parent) release_branch(b, level);
+        throw;
+    }
+    return b;
+}
+
+// 从level层建一条只有最左分支的路径，底部挂上leaf
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::new_path(size_type level, leaf_node *leaf) {
+    branch_node *b = new_branch();
+    if (level == bits) {
+        b->child[0] = leaf;
+        return b;
+    }
+    try {
+        b->child[0] = new_path(level - bits, leaf);
+    } catch (...) {
+        release_branch(b, level);
+        throw;
+    }
+    return b;
+}
+
+template <typename T, typename Alloc>
+void persistent_vector<T, Alloc>::assign(size_type n,
+                                         const value_type &value) {
+    if (n >= tail_offset()) {
+        if (unique(tail)) {
+            tail->data()[n & mask] = value;
+            return;
+        }
+        leaf_node *t = clone_leaf(tail, tail->count);
+        try {
+            t->data()[n & mask] = value;
+        } catch (...) {
+            release_leaf(t);
+            throw;
+        }
+        release_leaf(tail);
+        tail = t;
+        return;
+    }
+    branch_node *new_root = assign_path(shift, root, n, value);
+    if (new_root != root) {
+        release_branch(root, shift);
+        root = new_root;
+    }
+}
+
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::assign_path(size_type level, branch_node *parent,
+                                         size_type n,
+                                         const value_type &value) {
+    branch_node *b = writable(parent);
+    const size_type sub = (n >> level) & mask;
+    try {
+        if (level == bits) {
+            leaf_node *c = static_cast<leaf_node *>(b->child[sub]);
+            leaf_node *nc = unique(c) ? c : clone_leaf(c, c->count);
+            try {
+                nc->data()[n & mask] = value;
+            } catch (...) {
+                if (nc != c) release_leaf(nc);
+                throw;
+            }
+            if (nc != c) {
+                release_leaf(c);
+                b->child[sub] = nc;
+            }
+        } else {
+            branch_node *c = static_cast<branch_node *>(b->child[sub]);
+            branch_node *nc = assign_path(level - bits, c, n, value);
+            if (nc != c) {
+                release_branch(c, level - bits);
+                b->child[sub] = nc;
+            }
+        }
+    } catch (...) {
+        if (b != parent) release_branch(b, level);
+        throw;
+    }
+    return b;
+}
+
+template <typename T, typename Alloc>
+void persistent_vector<T, Alloc>::remove_last() {
+    if (tail->count > 1 || count == 1) {
+        if (unique(tail)) {
+            mystl::destroy(tail->data() + tail->count - 1);
+            --tail->count;
+        } else {
+            leaf_node *t = clone_leaf(tail, tail->count - 1);
+            release_leaf(tail);
+            tail = t;
+        }
+        if (--count == 0) {
+            release_leaf(tail);
+            tail = nullptr;
+        }
+        return;
+    }
+    // 尾部只剩一个元素：树中最后一个叶子成为新的尾部
+    leaf_node *new_tail = const_cast<leaf_node *>(leaf_for(count - 2));
+    retain(new_tail);
+    branch_node *new_root;
+    try {
+        new_root = pop_tail(shift, root);
+    } catch (...) {
+        release_leaf(new_tail);
+        throw;
+    }
+    if (new_root != root) release_branch(root, shift);
+    root = new_root;
+    if (root == nullptr) {
+        shift = bits;
+    } else if (shift > bits && root->child[1] == nullptr) {
+        // 根只剩一个孩子，树降低一层
+        branch_node *child = static_cast<branch_node *>(root->child[0]);
+        retain(child);
+        release_branch(root, shift);
+        root = child;
+        shift -= bits;
+    }
+    release_leaf(tail);
+    tail = new_tail;
+    --count;
+}
+
+// 去掉子树中最后一个叶子，子树因此变空时返回空指针
+template <typename T, typename Alloc>
+typename persistent_vector<T, Alloc>::branch_node *
+persistent_vector<T, Alloc>::pop_tail(size_type level, branch_node *parent) {
+    const size_type sub = ((count - 2) >> level) & mask;
+    if (level == bits) {
+        if (sub == 0) return nullptr;
+        branch_node *b = writable(parent);
+        release_leaf(static_cast<leaf_node *>(b->child[sub]));
+        b->child[sub] = nullptr;
+        return b;
+    }
+    branch_node *b = writable(parent);
+    branch_node *c = static_cast<branch_node *>(b->child[sub]);
+    branch_node *nc;
+    try {
+        nc = pop_tail(level - bits, c);
+    } catch (...) {
+        if (b != parent) release_branch(b, level);
+        throw;
+    }
+    if (nc == nullptr && sub == 0) {
+        if (b != parent) release_branch(b, level);
+        return nullptr;
+    }
+    if (nc != c) {
+        release_branch(c, level - bits);
+        b->child[sub] = nc;
+    }
+    return b;
+}
+
+template <typename T, typename Alloc>
+bool operator==(const persistent_vector<T, Alloc> &lhs,
+                const persistent_vector<T, Alloc> &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    typename persistent_vector<T, Alloc>::const_iterator i = lhs.begin();
+    typename persistent_vector<T, Alloc>::const_iterator j = rhs.begin();
+    for (; i != lhs.end(); ++i, ++j) {
+        if (!(*i == *j)) return false;
+    }
+    return true;
+}
+
+template <typename T, typename Alloc>
+bool operator!=(const persistent_vector<T, Alloc> &lhs,
+                const persistent_vector<T, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+}  // namespace mystl
@@ -0,0 +1,189 @@
+#pragma once
+
+// 节点式容器(list、map/set等)的软件预取遍历
+// 另用一个前导迭代器领先distance步，边走边对它所在的节点发出
+// __builtin_prefetch。前导迭代器本身仍要逐个加载节点，所以对纯粹的
+// 指针链帮助有限；真正的收益来自元素指向的外部数据(字符串缓冲区、
+// 指针成员等)：传入投影proj(元素)返回要预取的地址，这些加载与指针链无关，
+// 可以提前distance步并行发出。乱序执行窗口大的处理器自己就能重叠
+// 一部分这类加载，收益因硬件而异，使用前应实测。
+// 指针链本身的延迟应先用list::linearize()把节点按地址排好来消除。
+// 迭代器需要能多次遍历(前向迭代器)。
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "iterator.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define MYSTL_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace mystl {
+// 默认领先的步数
+constexpr size_t prefetch_distance = 8;
+
+namespace detail {
+template <class Iterator, class = void>
+struct has_node_member : std::false_type {};
+
+template <class Iterator>
+struct has_node_member<Iterator,
+                       decltype((void)std::declval<Iterator &>().node)>
+    : std::true_type {};
+
+// 不预取元素之外的数据
+struct prefetch_node_only {};
+
+// 带node成员的节点式迭代器，节点的链接部分和元素可能不在同一缓存行
+template <class Iterator>
+void prefetch_node(Iterator it, std::true_type) {
+    MYSTL_PREFETCH(static_cast<const void *>(it.node));
+    MYSTL_PREFETCH(static_cast<const void *>(&*it));
+}
+
+template <class Iterator>
+void prefetch_node(Iterator it, std::false_type) {
+    MYSTL_PREFETCH(static_cast<const void *>(&*it));
+}
+
+template <class Iterator>
+void prefetch_at(const Iterator &it, prefetch_node_only) {
+    detail::prefetch_node(it, has_node_member<Iterator>());
+}
+
+template <class Iterator, class Project>
+void prefetch_at(const Iterator &it, Project &proj) {
+    detail::prefetch_node(it, has_node_member<Iterator>());
+    MYSTL_PREFETCH(static_cast<const void *>(proj(*Iterator(it))));
+}
+}  // namespace detail
+
+// 对[first, last)中的每个元素调用f，同时预取前方distance步的节点，
+// 以及proj(元素)返回的地址
+template <class ForwardIterator, class Function, class Project,
+          typename std::enable_if<!std::is_integral<Project>::value,
+                                  int>::type = 0>
+Function for_each_prefetch(ForwardIterator first, ForwardIterator last,
+                           Function f, Project proj,
+                           size_t distance = prefetch_distance) {
+    ForwardIterator ahead = first;
+    for (size_t i = 0; i < distance && ahead != last; ++i, ++ahead) {
+        detail::prefetch_at(ahead, proj);
+    }
+    for (; first != last; ++first) {
+        if (ahead != last) {
+            detail::prefetch_at(ahead, proj);
+            ++ahead;
+        }
+        f(*first);
+    }
+    return f;
+}
+
+template <class ForwardIterator, class Function>
+Function for_each_prefetch(ForwardIterator first, ForwardIterator last,
+                           Function f, size_t distance = prefetch_distance) {
+    return mystl::for_each_prefetch(first, last, f,
+                                    detail::prefetch_node_only(), distance);
+}
+
+// 包装一个迭代器，每前进一步就预取前导迭代器所在的节点
+template <class Iterator, class Project = detail::prefetch_node_only>
+class prefetching_iterator {
+   public:
+    using iterator_category = forward_iterator_tag;
+    using value_type = typename iterator_traits<Iterator>::value_type;
+    using difference_type = typename iterator_traits<Iterator>::difference_type;
+    using pointer = typename iterator_traits<Iterator>::pointer;
+    using reference = typename iterator_traits<Iterator>::reference;
+
+    prefetching_iterator() = default;
+    prefetching_iterator(Iterator first, Iterator last, size_t distance,
+                         Project proj = Project())
+        : cur(first), ahead(first), last(last), proj(proj) {
+        for (size_t i = 0; i < distance && ahead != last; ++i, ++ahead) {
+            detail::prefetch_at(ahead, this->proj);
+        }
+    }
+
+    Iterator base() const { return cur; }
+
+    reference operator*() const { return *Iterator(cur); }
+    pointer operator->() const { return &operator*(); }
+
+    prefetching_iterator &operator++() {
+        if (ahead != last) {
+            detail::prefetch_at(ahead, proj);
+            ++ahead;
+        }
+        ++cur;
+        return *this;
+    }
+    prefetching_iterator operator++(int) {
+        prefetching_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(const prefetching_iterator &rhs) const {
+        return cur == rhs.cur;
+    }
+    bool operator!=(const prefetching_iterator &rhs) const {
+        return !(cur == rhs.cur);
+    }
+
+   private:
+    Iterator cur;
+    Iterator ahead;
+    Iterator last;
+    Project proj;
+};
+
+// 可以直接用于范围for：for (auto &x : mystl::prefetched(lst)) ...
+template <class Iterator, class Project = detail::prefetch_node_only>
+class prefetch_range {
+   public:
+    using iterator = prefetching_iterator<Iterator, Project>;
+
+    prefetch_range(Iterator first, Iterator last, size_t distance,
+                   Project proj = Project())
+        : first(first), last(last), distance(distance), proj(proj) {}
+
+    iterator begin() const { return iterator(first, last, distance, proj); }
+    iterator end() const { return iterator(last, last, 0, proj); }
+
+   private:
+    Iterator first;
+    Iterator last;
+    size_t distance;
+    Project proj;
+};
+
+template <class Iterator>
+prefetch_range<Iterator> prefetched(Iterator first, Iterator last,
+                                    size_t distance = prefetch_distance) {
+    return prefetch_range<Iterator>(first, last, distance);
+}
+
+template <class Container>
+auto prefetched(Container &c, size_t distance = prefetch_distance)
+    -> prefetch_range<decltype(c.begin())> {
+    return prefetch_range<decltype(c.begin())>(c.begin(), c.end(), distance);
+}
+
+// 同时预取proj(元素)返回的地址
+template <class Container, class Project,
+          typename std::enable_if<!std::is_integral<Project>::value,
+                                  int>::type = 0>
+auto prefetched(Container &c, Project proj,
+                size_t distance = prefetch_distance)
+    -> prefetch_range<decltype(c.begin()), Project> {
+    return prefetch_range<decltype(c.begin()), Project>(c.begin(), c.end(),
+                                                        distance, proj);
+}
+
+}  // namespace mystl
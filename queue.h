@@ -1,9 +1,10 @@
 #pragma once
 
-#include "list.h"
+#include "circular_buffer.h"
 
 namespace mystl {
-template <typename T, typename Container = mystl::list<T>>
+// 默认底层容器是circular_buffer，也可以使用deque、list或spsc_queue
+template <typename T, typename Container = mystl::circular_buffer<T>>
 class queue {
    public:
     using value_type = T;
@@ -20,6 +21,11 @@ class queue {
     reference front() { return con.front(); }
     reference back() { return con.back(); }
     void push(const value_type &value) { con.push_back(value); }
+    void push(value_type &&value) { con.push_back(mystl::move(value)); }
+    template <typename... Args>
+    void emplace(Args &&...args) {
+        con.emplace_back(mystl::forward<Args>(args)...);
+    }
     void pop() { con.pop_front(); }
 
     template <typename T1, typename C1>
@@ -226,9 +226,9 @@ class rb_tree_iterator : public rb_tree_iterator_base<T> {
     rb_tree_iterator() {}
     rb_tree_iterator(base_ptr x) { node = x; }
     rb_tree_iterator(node_ptr x) { node = x; }
-    rb_tree_iterator(iterator& x) { node = x.node; }
+    rb_tree_iterator(const iterator& x) { node = x.node; }
     // rb_tree_iterator(iterator&& x) { node = x.node; }
-    rb_tree_iterator(const_iterator& x) { node = x.node; }
+    rb_tree_iterator(const const_iterator& x) { node = x.node; }
 
     // member function
     reference operator*() const { return node->get_node_ptr()->value; }
@@ -279,8 +279,8 @@ class rb_tree_const_iterator : public rb_tree_iterator_base<T> {
     rb_tree_const_iterator() {}
     rb_tree_const_iterator(base_ptr x) { node = x; }
     rb_tree_const_iterator(node_ptr x) { node = x; }
-    rb_tree_const_iterator(iterator& x) { node = x.node; }
-    rb_tree_const_iterator(const_iterator& x) { node = x.node; }
+    rb_tree_const_iterator(const iterator& x) { node = x.node; }
+    rb_tree_const_iterator(const const_iterator& x) { node = x.node; }
 
     // member function
     reference operator*() const { return node->get_node_ptr()->value; }
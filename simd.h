@@ -0,0 +1,468 @@
+#pragma once
+
+// 连续内存上的向量化内核
+// x86上使用GCC/Clang的target属性编译AVX2版本，运行时检测CPU后分派，
+// 其他平台或编译器退化为标量实现
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "exceptdef.h"
+#include "type_traits.h"
+#include "util.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MYSTL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace mystl {
+namespace simd {
+
+// CPU特性检测，结果只计算一次
+inline bool has_avx2() {
+#ifdef MYSTL_SIMD_X86
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+#else
+    return false;
+#endif
+}
+
+// 单个64位字的popcount
+inline size_t popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(x));
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<size_t>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// 64位字中最低位1的下标，x不能为0
+inline size_t ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(x));
+#else
+    size_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**************************************************************************** */
+// popcount
+// 统计[p, p + n)个64位字中1的个数
+/**************************************************************************** */
+inline size_t popcount_scalar(const uint64_t *p, size_t n) {
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += popcount64(p[i]);
+        c1 += popcount64(p[i + 1]);
+        c2 += popcount64(p[i + 2]);
+        c3 += popcount64(p[i + 3]);
+    }
+    for (; i < n; ++i) {
+        c0 += popcount64(p[i]);
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+#ifdef MYSTL_SIMD_X86
+// 半字节查表法(pshufb)，每次处理256位，用sad累加到64位计数器
+__attribute__((target("avx2"))) inline size_t popcount_avx2(const uint64_t *p,
+                                                             size_t n) {
+    const __m256i lookup =
+        _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                         1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i));
+        const __m256i lo = _mm256_and_si256(v, low_mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                            _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc,
+                               _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    size_t result = static_cast<size_t>(_mm256_extract_epi64(acc, 0)) +
+                    static_cast<size_t>(_mm256_extract_epi64(acc, 1)) +
+                    static_cast<size_t>(_mm256_extract_epi64(acc, 2)) +
+                    static_cast<size_t>(_mm256_extract_epi64(acc, 3));
+    return result + popcount_scalar(p + i, n - i);
+}
+#endif
+
+inline size_t popcount(const uint64_t *p, size_t n) {
+#ifdef MYSTL_SIMD_X86
+    if (n >= 16 && has_avx2()) {
+        return popcount_avx2(p, n);
+    }
+#endif
+    return popcount_scalar(p, n);
+}
+
+/**************************************************************************** */
+// 算术类型连续区间上的比较与查找
+// 支持1/2/4/8字节的整型和float/double，其余类型退化为普通循环
+// 内核用GCC向量扩展编写一次，按16字节(SSE2)和32字节(AVX2)两种宽度实例化
+/**************************************************************************** */
+template <class T>
+struct is_vectorizable
+    : mystl::integral_constant<
+          bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                    !std::is_same<T, long double>::value &&
+                    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                     sizeof(T) == 8)> {};
+
+// 整型可以直接按字节比较是否相等
+template <class T>
+struct is_memcmp_equal
+    : mystl::integral_constant<bool, std::is_integral<T>::value> {};
+
+// 无符号单字节类型的字典序与memcmp一致
+template <class T>
+struct is_memcmp_ordered
+    : mystl::integral_constant<bool, std::is_integral<T>::value &&
+                                         std::is_unsigned<T>::value &&
+                                         sizeof(T) == 1> {};
+
+#ifdef MYSTL_SIMD_X86
+#define MYSTL_SIMD_INLINE __attribute__((always_inline)) inline
+
+namespace detail {
+// 比较结果掩码中是否有任一通道为真
+template <class Mask>
+MYSTL_SIMD_INLINE bool any_lane(const Mask &m) {
+    uint64_t words[sizeof(Mask) / 8];
+    std::memcpy(words, &m, sizeof(Mask));
+    uint64_t r = 0;
+    for (size_t k = 0; k < sizeof(Mask) / 8; ++k) {
+        r |= words[k];
+    }
+    return r != 0;
+}
+
+// 第一个不相等元素的下标，全部相等返回n
+template <class T, size_t Bytes>
+MYSTL_SIMD_INLINE size_t mismatch_kernel(const T *a, const T *b, size_t n) {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    constexpr size_t W = Bytes / sizeof(T);
+    size_t i = 0;
+    for (; i + W <= n; i += W) {
+        vec x, y;
+        std::memcpy(&x, a + i, Bytes);
+        std::memcpy(&y, b + i, Bytes);
+        if (any_lane(x != y)) break;
+    }
+    for (; i < n; ++i) {
+        if (!(a[i] == b[i])) return i;
+    }
+    return n;
+}
+
+template <class T, size_t Bytes>
+MYSTL_SIMD_INLINE size_t find_kernel(const T *p, size_t n, T value) {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    constexpr size_t W = Bytes / sizeof(T);
+    vec v = {};
+    v += value;
+    size_t i = 0;
+    for (; i + W <= n; i += W) {
+        vec x;
+        std::memcpy(&x, p + i, Bytes);
+        if (any_lane(x == v)) break;
+    }
+    for (; i < n; ++i) {
+        if (p[i] == value) return i;
+    }
+    return n;
+}
+
+// 比较掩码每个通道为0或-1，逐通道累减即得计数；
+// 每127轮归约一次，保证单字节通道不溢出
+template <class T, size_t Bytes>
+MYSTL_SIMD_INLINE size_t count_kernel(const T *p, size_t n, T value) {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    typedef decltype(vec{} == vec{}) mask;
+    constexpr size_t W = Bytes / sizeof(T);
+    vec v = {};
+    v += value;
+    const size_t blocks = n / W;
+    size_t result = 0;
+    size_t b = 0;
+    while (b < blocks) {
+        const size_t stop = blocks - b < 127 ? blocks : b + 127;
+        mask acc = {};
+        for (; b < stop; ++b) {
+            vec x;
+            std::memcpy(&x, p + b * W, Bytes);
+            acc -= (x == v);
+        }
+        for (size_t k = 0; k < W; ++k) {
+            result += static_cast<size_t>(acc[k]);
+        }
+    }
+    size_t i = blocks * W;
+    for (; i < n; ++i) {
+        result += p[i] == value;
+    }
+    return result;
+}
+
+// n必须大于0；浮点数含NaN时结果未定义
+template <class T, size_t Bytes>
+MYSTL_SIMD_INLINE mystl::pair<T, T> minmax_kernel(const T *p, size_t n) {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    constexpr size_t W = Bytes / sizeof(T);
+    T lo = p[0], hi = p[0];
+    size_t i = 0;
+    if (n >= W) {
+        vec vlo, vhi;
+        std::memcpy(&vlo, p, Bytes);
+        vhi = vlo;
+        for (i = W; i + W <= n; i += W) {
+            vec x;
+            std::memcpy(&x, p + i, Bytes);
+            vlo = x < vlo ? x : vlo;
+            vhi = vhi < x ? x : vhi;
+        }
+        for (size_t k = 0; k < W; ++k) {
+            if (vlo[k] < lo) lo = vlo[k];
+            if (hi < vhi[k]) hi = vhi[k];
+        }
+    }
+    for (; i < n; ++i) {
+        if (p[i] < lo) lo = p[i];
+        if (hi < p[i]) hi = p[i];
+    }
+    return mystl::pair<T, T>(lo, hi);
+}
+
+// 每个内核的SSE2(x86_64基线)与AVX2实例
+template <class T>
+size_t mismatch_sse2(const T *a, const T *b, size_t n) {
+    return mismatch_kernel<T, 16>(a, b, n);
+}
+template <class T>
+__attribute__((target("avx2"))) size_t mismatch_avx2(const T *a, const T *b,
+                                                      size_t n) {
+    return mismatch_kernel<T, 32>(a, b, n);
+}
+
+template <class T>
+size_t find_sse2(const T *p, size_t n, T value) {
+    return find_kernel<T, 16>(p, n, value);
+}
+template <class T>
+__attribute__((target("avx2"))) size_t find_avx2(const T *p, size_t n,
+                                                  T value) {
+    return find_kernel<T, 32>(p, n, value);
+}
+
+template <class T>
+size_t count_sse2(const T *p, size_t n, T value) {
+    return count_kernel<T, 16>(p, n, value);
+}
+template <class T>
+__attribute__((target("avx2"))) size_t count_avx2(const T *p, size_t n,
+                                                   T value) {
+    return count_kernel<T, 32>(p, n, value);
+}
+
+template <class T>
+mystl::pair<T, T> minmax_sse2(const T *p, size_t n) {
+    return minmax_kernel<T, 16>(p, n);
+}
+template <class T>
+__attribute__((target("avx2"))) mystl::pair<T, T> minmax_avx2(const T *p,
+                                                               size_t n) {
+    return minmax_kernel<T, 32>(p, n);
+}
+}  // namespace detail
+
+#undef MYSTL_SIMD_INLINE
+#endif
+
+// mismatch
+template <class T>
+size_t mismatch(const T *a, const T *b, size_t n, mystl::false_type) {
+    size_t i = 0;
+    while (i < n && a[i] == b[i]) ++i;
+    return i;
+}
+
+template <class T>
+size_t mismatch(const T *a, const T *b, size_t n, mystl::true_type) {
+#ifdef MYSTL_SIMD_X86
+    if (has_avx2()) return detail::mismatch_avx2(a, b, n);
+    return detail::mismatch_sse2(a, b, n);
+#else
+    return mismatch(a, b, n, mystl::false_type());
+#endif
+}
+
+// 第一个不满足a[i] == b[i]的下标，全部相等返回n
+template <class T>
+size_t mismatch(const T *a, const T *b, size_t n) {
+    return mystl::simd::mismatch(a, b, n, is_vectorizable<T>());
+}
+
+// equal
+template <class T>
+bool equal(const T *a, const T *b, size_t n, mystl::true_type) {
+    return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+}
+
+template <class T>
+bool equal(const T *a, const T *b, size_t n, mystl::false_type) {
+    return mystl::simd::mismatch(a, b, n) == n;
+}
+
+// [a, a + n)与[b, b + n)逐元素相等
+template <class T>
+bool equal(const T *a, const T *b, size_t n) {
+    return mystl::simd::equal(a, b, n, is_memcmp_equal<T>());
+}
+
+// lexicographical_compare
+template <class T>
+bool lexicographical_compare(const T *a, size_t na, const T *b, size_t nb,
+                             mystl::true_type) {
+    const size_t n = na < nb ? na : nb;
+    const int r = n == 0 ? 0 : std::memcmp(a, b, n);
+    return r != 0 ? r < 0 : na < nb;
+}
+
+// 算术类型：用向量化的mismatch跳过相等的前缀后比较；
+// 两者互不小于(如NaN)时视为等价并继续
+template <class T>
+bool lexicographical_compare_scan(const T *a, size_t na, const T *b,
+                                  size_t nb, mystl::true_type) {
+    const size_t n = na < nb ? na : nb;
+    size_t i = 0;
+    while ((i += mystl::simd::mismatch(a + i, b + i, n - i)) < n) {
+        if (a[i] < b[i]) return true;
+        if (b[i] < a[i]) return false;
+        ++i;
+    }
+    return na < nb;
+}
+
+// 其他类型只用operator<逐个比较，元素类型不必提供operator==
+template <class T>
+bool lexicographical_compare_scan(const T *a, size_t na, const T *b,
+                                  size_t nb, mystl::false_type) {
+    const size_t n = na < nb ? na : nb;
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] < b[i]) return true;
+        if (b[i] < a[i]) return false;
+    }
+    return na < nb;
+}
+
+template <class T>
+bool lexicographical_compare(const T *a, size_t na, const T *b, size_t nb,
+                             mystl::false_type) {
+    return mystl::simd::lexicographical_compare_scan(a, na, b, nb,
+                                                     is_vectorizable<T>());
+}
+
+// [a, a + na)字典序小于[b, b + nb)
+template <class T>
+bool lexicographical_compare(const T *a, size_t na, const T *b, size_t nb) {
+    return mystl::simd::lexicographical_compare(a, na, b, nb,
+                                                is_memcmp_ordered<T>());
+}
+
+// find
+template <class T>
+size_t find(const T *p, size_t n, const T &value, mystl::false_type) {
+    size_t i = 0;
+    while (i < n && !(p[i] == value)) ++i;
+    return i;
+}
+
+template <class T>
+size_t find(const T *p, size_t n, const T &value, mystl::true_type) {
+#ifdef MYSTL_SIMD_X86
+    if (has_avx2()) return detail::find_avx2(p, n, value);
+    return detail::find_sse2(p, n, value);
+#else
+    return find(p, n, value, mystl::false_type());
+#endif
+}
+
+// 第一个等于value的下标，没有则返回n
+template <class T>
+size_t find(const T *p, size_t n, const T &value) {
+    return mystl::simd::find(p, n, value, is_vectorizable<T>());
+}
+
+// count
+template <class T>
+size_t count(const T *p, size_t n, const T &value, mystl::false_type) {
+    size_t result = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] == value) ++result;
+    }
+    return result;
+}
+
+template <class T>
+size_t count(const T *p, size_t n, const T &value, mystl::true_type) {
+#ifdef MYSTL_SIMD_X86
+    if (has_avx2()) return detail::count_avx2(p, n, value);
+    return detail::count_sse2(p, n, value);
+#else
+    return count(p, n, value, mystl::false_type());
+#endif
+}
+
+// 等于value的元素个数
+template <class T>
+size_t count(const T *p, size_t n, const T &value) {
+    return mystl::simd::count(p, n, value, is_vectorizable<T>());
+}
+
+// minmax
+template <class T>
+mystl::pair<T, T> minmax(const T *p, size_t n, mystl::false_type) {
+    T lo = p[0], hi = p[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (p[i] < lo) lo = p[i];
+        if (hi < p[i]) hi = p[i];
+    }
+    return mystl::pair<T, T>(lo, hi);
+}
+
+template <class T>
+mystl::pair<T, T> minmax(const T *p, size_t n, mystl::true_type) {
+#ifdef MYSTL_SIMD_X86
+    if (has_avx2()) return detail::minmax_avx2(p, n);
+    return detail::minmax_sse2(p, n);
+#else
+    return minmax(p, n, mystl::false_type());
+#endif
+}
+
+// 最小值和最大值，n必须大于0
+template <class T>
+mystl::pair<T, T> minmax(const T *p, size_t n) {
+    MYSTL_DEBUG(n > 0);
+    return mystl::simd::minmax(p, n, is_vectorizable<T>());
+}
+
+}  // namespace simd
+}  // namespace mystl
@@ -0,0 +1,466 @@
+#pragma once
+
+// 结构数组(SoA)容器：soa_vector<Ts...>的每个字段各自存放在一段连续内存中
+// 按行访问通过代理引用，按列访问直接拿到column_span，便于只扫描一两个字段的循环
+
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "alloc.h"
+#include "exceptdef.h"
+#include "uninitialized.h"
+
+namespace mystl {
+// 一列数据的连续视图
+template <typename T>
+class column_span {
+   public:
+    using value_type = typename std::remove_const<T>::type;
+    using size_type = size_t;
+    using pointer = T *;
+    using reference = T &;
+    using iterator = T *;
+
+    column_span() : ptr(nullptr), len(0) {}
+    column_span(T *ptr, size_type len) : ptr(ptr), len(len) {}
+
+    iterator begin() const { return ptr; }
+    iterator end() const { return ptr + len; }
+    pointer data() const { return ptr; }
+    size_type size() const { return len; }
+    bool empty() const { return len == 0; }
+    reference operator[](size_type n) const { return ptr[n]; }
+
+   private:
+    T *ptr;
+    size_type len;
+};
+
+template <typename... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+
+   public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    static constexpr size_type field_count = sizeof...(Ts);
+
+    template <size_t I>
+    using field_type = typename std::tuple_element<I, value_type>::type;
+
+    // 行代理引用，Const为true时只读
+    template <bool Const>
+    class row_reference {
+       public:
+        using columns_type =
+            typename std::conditional<Const, std::tuple<const Ts *...>,
+                                      std::tuple<Ts *...>>::type;
+
+        row_reference(const columns_type &cols, size_type index)
+            : cols(cols), index(index) {}
+
+        template <size_t I>
+        auto &get() const {
+            return std::get<I>(cols)[index];
+        }
+
+        // 整行赋值，写入引用的那一行而不是重新绑定代理(只读引用不可用)
+        const row_reference &operator=(const value_type &value) const {
+            assign(value, std::index_sequence_for<Ts...>());
+            return *this;
+        }
+        const row_reference &operator=(const row_reference &rhs) const {
+            return *this = static_cast<value_type>(rhs);
+        }
+
+        // 拷贝出整行
+        operator value_type() const {
+            return load(std::index_sequence_for<Ts...>());
+        }
+
+       private:
+        template <size_t... Is>
+        void assign(const value_type &value, std::index_sequence<Is...>) const {
+            ((std::get<Is>(cols)[index] = std::get<Is>(value)), ...);
+        }
+        template <size_t... Is>
+        value_type load(std::index_sequence<Is...>) const {
+            return value_type(std::get<Is>(cols)[index]...);
+        }
+
+        columns_type cols;
+        size_type index;
+    };
+
+    using reference = row_reference<false>;
+    using const_reference = row_reference<true>;
+
+    // 按行下标遍历的迭代器，解引用得到代理引用
+    template <bool Const>
+    class row_iterator {
+       public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = soa_vector::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = row_reference<Const>;
+        using pointer = void;
+        using owner_pointer =
+            typename std::conditional<Const, const soa_vector *,
+                                      soa_vector *>::type;
+
+        row_iterator() : owner(nullptr), index(0) {}
+        row_iterator(owner_pointer owner, size_type index)
+            : owner(owner), index(index) {}
+
+        reference operator*() const { return (*owner)[index]; }
+        reference operator[](difference_type n) const {
+            return (*owner)[index + n];
+        }
+
+        row_iterator &operator++() {
+            ++index;
+            return *this;
+        }
+        row_iterator operator++(int) {
+            row_iterator tmp = *this;
+            ++index;
+            return tmp;
+        }
+        row_iterator &operator--() {
+            --index;
+            return *this;
+        }
+        row_iterator operator--(int) {
+            row_iterator tmp = *this;
+            --index;
+            return tmp;
+        }
+        row_iterator &operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        row_iterator &operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        row_iterator operator+(difference_type n) const {
+            return row_iterator(owner, index + n);
+        }
+        row_iterator operator-(difference_type n) const {
+            return row_iterator(owner, index - n);
+        }
+        difference_type operator-(const row_iterator &rhs) const {
+            return static_cast<difference_type>(index) -
+                   static_cast<difference_type>(rhs.index);
+        }
+
+        bool operator==(const row_iterator &rhs) const {
+            return index == rhs.index;
+        }
+        bool operator!=(const row_iterator &rhs) const {
+            return index != rhs.index;
+        }
+        bool operator<(const row_iterator &rhs) const {
+            return index < rhs.index;
+        }
+
+        size_type position() const { return index; }
+
+       private:
+        owner_pointer owner;
+        size_type index;
+    };
+
+    using iterator = row_iterator<false>;
+    using const_iterator = row_iterator<true>;
+
+   protected:
+    std::tuple<Ts *...> columns;
+    size_type count;
+    size_type capacity;
+
+    // 辅助函数
+    template <typename F, size_t... Is>
+    static void for_each_index(F &&f, std::index_sequence<Is...>) {
+        (f(std::integral_constant<size_t, Is>()), ...);
+    }
+    // 对每一列调用f(integral_constant<size_t, I>)
+    template <typename F>
+    static void for_each_field(F &&f) {
+        for_each_index(f, std::index_sequence_for<Ts...>());
+    }
+
+    void reallocate(size_type new_capacity);
+    void grow();
+    void release();
+    void destroy_range(size_type first, size_type last);
+
+    template <typename... Args>
+    void construct_row(size_type index, Args &&...args);
+
+    void copy_from(const soa_vector &rhs);
+
+   public:
+    // 构造函数
+    soa_vector() : columns(), count(0), capacity(0) {}
+    explicit soa_vector(size_type n) : soa_vector() { resize(n); }
+    soa_vector(const soa_vector &rhs) : soa_vector() { copy_from(rhs); }
+    soa_vector(soa_vector &&rhs) noexcept
+        : columns(rhs.columns), count(rhs.count), capacity(rhs.capacity) {
+        rhs.columns = std::tuple<Ts *...>();
+        rhs.count = 0;
+        rhs.capacity = 0;
+    }
+
+    soa_vector &operator=(const soa_vector &rhs) {
+        if (this != &rhs) {
+            clear();
+            copy_from(rhs);
+        }
+        return *this;
+    }
+    soa_vector &operator=(soa_vector &&rhs) noexcept {
+        if (this != &rhs) {
+            soa_vector tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 析构函数
+    ~soa_vector() { release(); }
+
+    // 迭代器
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    iterator end() { return iterator(this, count); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+    // 容量
+    size_type size() const { return count; }
+    size_type cap() const { return capacity; }
+    bool empty() const { return count == 0; }
+    void reserve(size_type n) {
+        if (n > capacity) reallocate(n);
+    }
+
+    // 按行访问
+    reference operator[](size_type n) { return reference(columns, n); }
+    const_reference operator[](size_type n) const {
+        return const_reference(const_columns(), n);
+    }
+    reference at(size_type n) {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "soa_vector<Ts...>::at");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "soa_vector<Ts...>::at");
+        return (*this)[n];
+    }
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[count - 1]; }
+    const_reference back() const { return (*this)[count - 1]; }
+
+    // 按列访问
+    template <size_t I>
+    field_type<I> *data() {
+        return std::get<I>(columns);
+    }
+    template <size_t I>
+    const field_type<I> *data() const {
+        return std::get<I>(columns);
+    }
+    template <size_t I>
+    column_span<field_type<I>> column() {
+        return column_span<field_type<I>>(std::get<I>(columns), count);
+    }
+    template <size_t I>
+    column_span<const field_type<I>> column() const {
+        return column_span<const field_type<I>>(std::get<I>(columns), count);
+    }
+
+    // 修改
+    void push_back(const Ts &...values) { emplace_back(values...); }
+    void push_back(Ts &&...values) { emplace_back(std::move(values)...); }
+    void push_back(const value_type &row) {
+        std::apply([this](const Ts &...values) { emplace_back(values...); },
+                   row);
+    }
+
+    // 每个参数构造对应的一列
+    template <typename... Args>
+    reference emplace_back(Args &&...args);
+
+    void pop_back();
+    iterator erase(iterator position);
+    iterator erase(iterator first, iterator last);
+    void resize(size_type new_size);
+    void clear();
+    void swap(soa_vector &rhs) noexcept {
+        std::swap(columns, rhs.columns);
+        std::swap(count, rhs.count);
+        std::swap(capacity, rhs.capacity);
+    }
+
+   private:
+    std::tuple<const Ts *...> const_columns() const {
+        return std::tuple<const Ts *...>(columns);
+    }
+};
+
+template <typename... Ts>
+void soa_vector<Ts...>::reallocate(size_type new_capacity) {
+    std::tuple<Ts *...> new_columns;
+    size_type moved = 0;
+    try {
+        for_each_field([&](auto I) {
+            using T = field_type<decltype(I)::value>;
+            T *p = simple_alloc<T>::allocate(new_capacity);
+            std::get<I>(new_columns) = p;
+            mystl::uninitialized_move(std::get<I>(columns),
+                                      std::get<I>(columns) + count, p);
+            ++moved;
+        });
+    } catch (const std::exception &e) {
+        size_type i = 0;
+        for_each_field([&](auto I) {
+            using T = field_type<decltype(I)::value>;
+            T *p = std::get<I>(new_columns);
+            if (p != nullptr) {
+                if (i < moved) mystl::destroy(p, p + count);
+                simple_alloc<T>::deallocate(p, new_capacity);
+            }
+            ++i;
+        });
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+    release();
+    columns = new_columns;
+    capacity = new_capacity;
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::grow() {
+    reallocate(capacity == 0 ? 8 : 2 * capacity);
+}
+
+// 析构所有元素并释放每一列
+template <typename... Ts>
+void soa_vector<Ts...>::release() {
+    for_each_field([&](auto I) {
+        using T = field_type<decltype(I)::value>;
+        T *p = std::get<I>(columns);
+        if (p != nullptr) {
+            mystl::destroy(p, p + count);
+            simple_alloc<T>::deallocate(p, capacity);
+        }
+    });
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::destroy_range(size_type first, size_type last) {
+    for_each_field([&](auto I) {
+        mystl::destroy(std::get<I>(columns) + first,
+                       std::get<I>(columns) + last);
+    });
+}
+
+// 在index处逐列构造，中途抛出异常时析构已构造的列
+template <typename... Ts>
+template <typename... Args>
+void soa_vector<Ts...>::construct_row(size_type index, Args &&...args) {
+    static_assert(sizeof...(Args) == sizeof...(Ts),
+                  "one argument per soa_vector field");
+    auto values = std::forward_as_tuple(std::forward<Args>(args)...);
+    size_type built = 0;
+    try {
+        for_each_field([&](auto I) {
+            mystl::construct(std::get<I>(columns) + index,
+                             std::get<I>(std::move(values)));
+            ++built;
+        });
+    } catch (const std::exception &e) {
+        size_type i = 0;
+        for_each_field([&](auto I) {
+            if (i++ < built) mystl::destroy(std::get<I>(columns) + index);
+        });
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::copy_from(const soa_vector &rhs) {
+    reserve(rhs.count);
+    for (size_type i = 0; i < rhs.count; ++i) {
+        std::apply(
+            [&](const Ts *...cols) { construct_row(count, cols[i]...); },
+            rhs.const_columns());
+        ++count;
+    }
+}
+
+template <typename... Ts>
+template <typename... Args>
+typename soa_vector<Ts...>::reference soa_vector<Ts...>::emplace_back(
+    Args &&...args) {
+    if (count == capacity) grow();
+    construct_row(count, std::forward<Args>(args)...);
+    ++count;
+    return back();
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::pop_back() {
+    --count;
+    destroy_range(count, count + 1);
+}
+
+template <typename... Ts>
+typename soa_vector<Ts...>::iterator soa_vector<Ts...>::erase(
+    iterator position) {
+    return erase(position, position + 1);
+}
+
+// 每列独立地把后半段前移，再析构尾部
+template <typename... Ts>
+typename soa_vector<Ts...>::iterator soa_vector<Ts...>::erase(iterator first,
+                                                              iterator last) {
+    const size_type b = first.position();
+    const size_type e = last.position();
+    if (b != e) {
+        for_each_field([&](auto I) {
+            auto p = std::get<I>(columns);
+            std::move(p + e, p + count, p + b);
+        });
+        destroy_range(count - (e - b), count);
+        count -= e - b;
+    }
+    return iterator(this, b);
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::resize(size_type new_size) {
+    if (new_size < count) {
+        destroy_range(new_size, count);
+        count = new_size;
+        return;
+    }
+    reserve(new_size);
+    for (; count < new_size; ++count) {
+        construct_row(count, Ts()...);
+    }
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::clear() {
+    destroy_range(0, count);
+    count = 0;
+}
+}  // namespace mystl
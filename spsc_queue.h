@@ -0,0 +1,248 @@
+#pragma once
+
+// 有界单生产者单消费者环形队列，不加锁，构造之后不再分配内存
+// 容量Capacity为2的幂，head和tail是只增不减的计数，取模用掩码。
+// 生产者只写tail，消费者只写head，两者分处不同缓存行；
+// 各自再缓存一份对方的下标，只有看起来满或空时才去读对方的缓存行。
+// 生产者线程：try_push/try_emplace/push_n/push_back/back
+// 消费者线程：try_pop/pop_n/front/pop_front
+// 同一时刻最多一个生产者线程和一个消费者线程，其他操作不能与它们并发。
+// 提供push_back/pop_front/front/back/empty/size，可以作为queue的底层容器，
+// 此时push_back在队列满时等待消费者取走元素。
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+#include "allocator.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl {
+template <typename T, size_t Capacity = 1024,
+          typename Alloc = mystl::allocator<T>>
+class spsc_queue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "spsc_queue capacity must be a power of two");
+
+   public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+
+   protected:
+    static constexpr size_type mask = Capacity - 1;
+
+    // 两端共享只读
+    pointer buffer;
+    // 消费者写
+    alignas(cache_line_size) std::atomic<size_type> head;
+    size_type cached_tail;
+    // 生产者写
+    alignas(cache_line_size) std::atomic<size_type> tail;
+    size_type cached_head;
+
+    // 生产者：至少还有n个空位时返回true
+    bool has_room(size_type t, size_type n) {
+        if (Capacity - (t - cached_head) >= n) return true;
+        cached_head = head.load(std::memory_order_acquire);
+        return Capacity - (t - cached_head) >= n;
+    }
+    // 消费者：至少有一个元素时返回true
+    bool has_item(size_type h) {
+        if (h != cached_tail) return true;
+        cached_tail = tail.load(std::memory_order_acquire);
+        return h != cached_tail;
+    }
+
+   public:
+    // 构造函数
+    spsc_queue()
+        : buffer(allocator_type::allocate(Capacity)),
+          head(0),
+          cached_tail(0),
+          tail(0),
+          cached_head(0) {}
+    spsc_queue(const spsc_queue &) = delete;
+    spsc_queue &operator=(const spsc_queue &) = delete;
+
+    // 析构函数
+    ~spsc_queue() {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        for (size_type h = head.load(std::memory_order_relaxed); h != t; ++h) {
+            mystl::destroy(buffer + (h & mask));
+        }
+        allocator_type::deallocate(buffer, Capacity);
+    }
+
+    // 容量，并发时size()只是某一时刻的近似值
+    static constexpr size_type capacity() { return Capacity; }
+    size_type size() const {
+        return tail.load(std::memory_order_acquire) -
+               head.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == Capacity; }
+
+    // 生产者接口，队列满时返回false
+    template <typename... Args>
+    bool try_emplace(Args &&...args) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        if (!has_room(t, 1)) return false;
+        mystl::construct(buffer + (t & mask), mystl::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool try_push(const value_type &value) { return try_emplace(value); }
+    bool try_push(value_type &&value) {
+        return try_emplace(mystl::move(value));
+    }
+
+    // 批量写入[first, first + n)中能放下的部分，只发布一次tail，返回写入的个数。
+    // value_type *也走指针版本，否则模板是精确匹配，会抢走重载
+    size_type push_n(const value_type *first, size_type n);
+    template <typename InputIterator,
+              typename std::enable_if<
+                  !std::is_same<InputIterator, value_type *>::value,
+                  int>::type = 0>
+    size_type push_n(InputIterator first, size_type n);
+
+    // 作为queue的底层容器时使用，队列满时让出CPU等待
+    template <typename... Args>
+    void emplace_back(Args &&...args) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        while (!has_room(t, 1)) {
+            std::this_thread::yield();
+        }
+        mystl::construct(buffer + (t & mask), mystl::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+    }
+    void push_back(const value_type &value) { emplace_back(value); }
+    void push_back(value_type &&value) { emplace_back(mystl::move(value)); }
+    // 最后写入的元素，只能由生产者调用
+    reference back() {
+        return buffer[(tail.load(std::memory_order_relaxed) - 1) & mask];
+    }
+
+    // 消费者接口，队列空时返回false
+    bool try_pop(value_type &value) {
+        const size_type h = head.load(std::memory_order_relaxed);
+        if (!has_item(h)) return false;
+        pointer p = buffer + (h & mask);
+        value = mystl::move(*p);
+        mystl::destroy(p);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 批量取出最多n个元素移动赋值到result开始的位置，返回取出的个数
+    size_type pop_n(value_type *result, size_type n);
+    template <typename OutputIterator>
+    size_type pop_n(OutputIterator result, size_type n);
+
+    // 队首元素，调用前需保证队列非空
+    reference front() {
+        const size_type h = head.load(std::memory_order_relaxed);
+        MYSTL_DEBUG(has_item(h));
+        return buffer[h & mask];
+    }
+    void pop_front() {
+        const size_type h = head.load(std::memory_order_relaxed);
+        MYSTL_DEBUG(has_item(h));
+        mystl::destroy(buffer + (h & mask));
+        head.store(h + 1, std::memory_order_release);
+    }
+};
+
+// 环形缓冲区中的空位最多分成两段，每段整体拷贝，平凡类型就是memmove
+template <typename T, size_t Capacity, typename Alloc>
+typename spsc_queue<T, Capacity, Alloc>::size_type
+spsc_queue<T, Capacity, Alloc>::push_n(const value_type *first, size_type n) {
+    const size_type t = tail.load(std::memory_order_relaxed);
+    if (!has_room(t, n)) {
+        n = Capacity - (t - cached_head);
+    }
+    const size_type pos = t & mask;
+    const size_type len = Capacity - pos < n ? Capacity - pos : n;
+    mystl::uninitialized_copy(first, first + len, buffer + pos);
+    try {
+        mystl::uninitialized_copy(first + len, first + n, buffer);
+    } catch (const std::exception &e) {
+        mystl::destroy(buffer + pos, buffer + pos + len);
+        throw;
+    }
+    tail.store(t + n, std::memory_order_release);
+    return n;
+}
+
+template <typename T, size_t Capacity, typename Alloc>
+template <typename InputIterator,
+          typename std::enable_if<
+              !std::is_same<InputIterator, T *>::value, int>::type>
+typename spsc_queue<T, Capacity, Alloc>::size_type
+spsc_queue<T, Capacity, Alloc>::push_n(InputIterator first, size_type n) {
+    const size_type t = tail.load(std::memory_order_relaxed);
+    if (!has_room(t, n)) {
+        n = Capacity - (t - cached_head);
+    }
+    size_type i = 0;
+    try {
+        for (; i < n; ++i, ++first) {
+            mystl::construct(buffer + ((t + i) & mask), *first);
+        }
+    } catch (const std::exception &e) {
+        // 已经构造好的元素照常发布
+        tail.store(t + i, std::memory_order_release);
+        throw;
+    }
+    tail.store(t + n, std::memory_order_release);
+    return n;
+}
+
+template <typename T, size_t Capacity, typename Alloc>
+typename spsc_queue<T, Capacity, Alloc>::size_type
+spsc_queue<T, Capacity, Alloc>::pop_n(value_type *result, size_type n) {
+    const size_type h = head.load(std::memory_order_relaxed);
+    size_type avail = cached_tail - h;
+    if (avail < n) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        avail = cached_tail - h;
+        if (avail < n) n = avail;
+    }
+    const size_type pos = h & mask;
+    const size_type len = Capacity - pos < n ? Capacity - pos : n;
+    mystl::move(buffer + pos, buffer + pos + len, result);
+    mystl::move(buffer, buffer + (n - len), result + len);
+    mystl::destroy(buffer + pos, buffer + pos + len);
+    mystl::destroy(buffer, buffer + (n - len));
+    head.store(h + n, std::memory_order_release);
+    return n;
+}
+
+template <typename T, size_t Capacity, typename Alloc>
+template <typename OutputIterator>
+typename spsc_queue<T, Capacity, Alloc>::size_type
+spsc_queue<T, Capacity, Alloc>::pop_n(OutputIterator result, size_type n) {
+    const size_type h = head.load(std::memory_order_relaxed);
+    size_type avail = cached_tail - h;
+    if (avail < n) {
+        cached_tail = tail.load(std::memory_order_acquire);
+        avail = cached_tail - h;
+        if (avail < n) n = avail;
+    }
+    for (size_type i = 0; i < n; ++i, ++result) {
+        pointer p = buffer + ((h + i) & mask);
+        *result = mystl::move(*p);
+        mystl::destroy(p);
+    }
+    head.store(h + n, std::memory_order_release);
+    return n;
+}
+}  // namespace mystl
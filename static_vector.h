@@ -0,0 +1,260 @@
+#pragma once
+
+// 定长内联向量：元素存放在对象内部，最多N个，不使用堆
+// 平凡类型T的static_vector本身可平凡拷贝，并且可以在constexpr中使用
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "exceptdef.h"
+
+namespace mystl {
+// 存储基类，按T是否平凡选择实现
+template <typename T, size_t N, bool = std::is_trivial<T>::value>
+class static_vector_storage;
+
+// 平凡类型：直接用数组保存，拷贝、析构都是平凡的
+template <typename T, size_t N>
+class static_vector_storage<T, N, true> {
+   protected:
+    // constexpr对象要求每个成员都初始化，N很小时清零的开销可以忽略
+    T elems[N == 0 ? 1 : N] = {};
+    size_t count = 0;
+
+    constexpr T *ptr() { return elems; }
+    constexpr const T *ptr() const { return elems; }
+
+    template <typename... Args>
+    constexpr void construct_at(size_t i, Args &&...args) {
+        elems[i] = T(std::forward<Args>(args)...);
+    }
+    constexpr void destroy_at(size_t) {}
+};
+
+// 非平凡类型：未初始化的对齐内存，按需构造和析构
+template <typename T, size_t N>
+class static_vector_storage<T, N, false> {
+   protected:
+    alignas(T) unsigned char raw[sizeof(T) * (N == 0 ? 1 : N)];
+    size_t count;
+
+    T *ptr() { return std::launder(reinterpret_cast<T *>(raw)); }
+    const T *ptr() const {
+        return std::launder(reinterpret_cast<const T *>(raw));
+    }
+
+    template <typename... Args>
+    void construct_at(size_t i, Args &&...args) {
+        ::new (static_cast<void *>(raw + i * sizeof(T)))
+            T(std::forward<Args>(args)...);
+    }
+    void destroy_at(size_t i) { ptr()[i].~T(); }
+
+    void destroy_all() {
+        for (; count > 0; --count) destroy_at(count - 1);
+    }
+
+   public:
+    static_vector_storage() : count(0) {}
+    static_vector_storage(const static_vector_storage &rhs) : count(0) {
+        for (; count < rhs.count; ++count) construct_at(count, rhs.ptr()[count]);
+    }
+    static_vector_storage(static_vector_storage &&rhs) : count(0) {
+        for (; count < rhs.count; ++count) {
+            construct_at(count, std::move(rhs.ptr()[count]));
+        }
+    }
+    static_vector_storage &operator=(const static_vector_storage &rhs) {
+        if (this != &rhs) {
+            destroy_all();
+            for (; count < rhs.count; ++count) {
+                construct_at(count, rhs.ptr()[count]);
+            }
+        }
+        return *this;
+    }
+    static_vector_storage &operator=(static_vector_storage &&rhs) {
+        if (this != &rhs) {
+            destroy_all();
+            for (; count < rhs.count; ++count) {
+                construct_at(count, std::move(rhs.ptr()[count]));
+            }
+        }
+        return *this;
+    }
+    ~static_vector_storage() { destroy_all(); }
+};
+
+template <typename T, size_t N>
+class static_vector : private static_vector_storage<T, N> {
+    using base = static_vector_storage<T, N>;
+    using base::construct_at;
+    using base::count;
+    using base::destroy_at;
+    using base::ptr;
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    // 构造函数
+    constexpr static_vector() = default;
+    constexpr explicit static_vector(size_type n) { resize(n); }
+    constexpr static_vector(size_type n, const value_type &value) {
+        resize(n, value);
+    }
+    constexpr static_vector(std::initializer_list<value_type> il) {
+        for (const value_type &value : il) push_back(value);
+    }
+    template <typename InputIterator,
+              typename = decltype(*std::declval<InputIterator &>(),
+                                  ++std::declval<InputIterator &>())>
+    constexpr static_vector(InputIterator first, InputIterator last) {
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    // 迭代器
+    constexpr iterator begin() { return ptr(); }
+    constexpr const_iterator begin() const { return ptr(); }
+    constexpr iterator end() { return ptr() + count; }
+    constexpr const_iterator end() const { return ptr() + count; }
+    constexpr const_iterator cbegin() const { return begin(); }
+    constexpr const_iterator cend() const { return end(); }
+
+    // 容量
+    constexpr size_type size() const { return count; }
+    static constexpr size_type capacity() { return N; }
+    static constexpr size_type max_size() { return N; }
+    constexpr bool empty() const { return count == 0; }
+    constexpr bool full() const { return count == N; }
+
+    // 访问
+    constexpr pointer data() { return ptr(); }
+    constexpr const_pointer data() const { return ptr(); }
+    constexpr reference operator[](size_type n) { return ptr()[n]; }
+    constexpr const_reference operator[](size_type n) const {
+        return ptr()[n];
+    }
+    constexpr reference at(size_type n) {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "static_vector<T, N>::at");
+        return ptr()[n];
+    }
+    constexpr const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "static_vector<T, N>::at");
+        return ptr()[n];
+    }
+    constexpr reference front() { return ptr()[0]; }
+    constexpr const_reference front() const { return ptr()[0]; }
+    constexpr reference back() { return ptr()[count - 1]; }
+    constexpr const_reference back() const { return ptr()[count - 1]; }
+
+    // 修改，超出容量时抛出length_error
+    constexpr void push_back(const value_type &value) { emplace_back(value); }
+    constexpr void push_back(value_type &&value) {
+        emplace_back(std::move(value));
+    }
+    template <typename... Args>
+    constexpr reference emplace_back(Args &&...args) {
+        MYSTL_LENGTH_ERROR_IF(count == N, "static_vector<T, N> is full");
+        construct_at(count, std::forward<Args>(args)...);
+        ++count;
+        return back();
+    }
+    constexpr void pop_back() {
+        --count;
+        destroy_at(count);
+    }
+
+    constexpr iterator insert(const_iterator position, const value_type &value) {
+        return emplace(position, value);
+    }
+    constexpr iterator insert(const_iterator position, value_type &&value) {
+        return emplace(position, std::move(value));
+    }
+    // 先在尾部构造，再逐个后移，最后放入新值
+    template <typename... Args>
+    constexpr iterator emplace(const_iterator position, Args &&...args) {
+        const size_type index = static_cast<size_type>(position - begin());
+        emplace_back(std::forward<Args>(args)...);
+        for (size_type i = count - 1; i > index; --i) {
+            value_type tmp = std::move(ptr()[i]);
+            ptr()[i] = std::move(ptr()[i - 1]);
+            ptr()[i - 1] = std::move(tmp);
+        }
+        return begin() + index;
+    }
+
+    constexpr iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        const size_type b = static_cast<size_type>(first - begin());
+        const size_type e = static_cast<size_type>(last - begin());
+        if (b != e) {
+            for (size_type i = e; i < count; ++i) {
+                ptr()[b + (i - e)] = std::move(ptr()[i]);
+            }
+            const size_type new_count = count - (e - b);
+            while (count > new_count) pop_back();
+        }
+        return begin() + b;
+    }
+
+    constexpr void resize(size_type n) {
+        MYSTL_LENGTH_ERROR_IF(n > N, "static_vector<T, N>::resize");
+        while (count > n) pop_back();
+        while (count < n) emplace_back();
+    }
+    constexpr void resize(size_type n, const value_type &value) {
+        MYSTL_LENGTH_ERROR_IF(n > N, "static_vector<T, N>::resize");
+        while (count > n) pop_back();
+        while (count < n) emplace_back(value);
+    }
+    constexpr void clear() {
+        while (count > 0) pop_back();
+    }
+
+    constexpr void swap(static_vector &rhs) {
+        static_vector tmp(std::move(rhs));
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+};
+
+template <typename T, size_t N>
+constexpr bool operator==(const static_vector<T, N> &lhs,
+                          const static_vector<T, N> &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (!(lhs[i] == rhs[i])) return false;
+    }
+    return true;
+}
+
+template <typename T, size_t N>
+constexpr bool operator!=(const static_vector<T, N> &lhs,
+                          const static_vector<T, N> &rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, size_t N>
+constexpr bool operator<(const static_vector<T, N> &lhs,
+                         const static_vector<T, N> &rhs) {
+    const size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    for (size_t i = 0; i < n; ++i) {
+        if (lhs[i] < rhs[i]) return true;
+        if (rhs[i] < lhs[i]) return false;
+    }
+    return lhs.size() < rhs.size();
+}
+}  // namespace mystl
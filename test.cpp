@@ -1,7 +1,919 @@
+#include <algorithm>
+#include <cstdint>
+#include <deque>
 #include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "mystl.h"  // 假设 rb_tree 的定义在这个头文件中
 
+// 并发和随机测试的结果，任何一项失败时main返回非零
+static bool all_passed = true;
+
+static void report(const char *name, bool ok) {
+    std::cout << name << ": " << (ok ? "Success" : "Fail") << std::endl;
+    if (!ok) all_passed = false;
+}
+
+// spsc_queue：生产者交替用try_push和push_n写入0..n-1，
+// 消费者交替用try_pop和pop_n读出，必须按顺序一个不差
+static bool test_spsc_queue_stress() {
+    const uint64_t n = 2000000;
+    mystl::spsc_queue<uint64_t, 256> q;
+    std::thread producer([&] {
+        uint64_t next = 0;
+        uint64_t batch[37];
+        while (next < n) {
+            if (next % 3 == 0) {
+                uint64_t k = 0;
+                for (; k < 37 && next + k < n; ++k) batch[k] = next + k;
+                next += q.push_n(batch, k);
+            } else if (q.try_push(next)) {
+                ++next;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    bool ok = true;
+    uint64_t expect = 0;
+    uint64_t batch[29];
+    while (expect < n) {
+        uint64_t got = 0;
+        if (expect % 2 == 0) {
+            got = q.pop_n(batch, 29);
+            for (uint64_t k = 0; k < got; ++k) {
+                if (batch[k] != expect + k) ok = false;
+            }
+        } else if (q.try_pop(batch[0])) {
+            got = 1;
+            if (batch[0] != expect) ok = false;
+        }
+        if (got == 0) std::this_thread::yield();
+        expect += got;
+    }
+    producer.join();
+    return ok && q.empty();
+}
+
+// mpmc_queue：多个生产者写入(生产者编号, 序号)，多个消费者取出，
+// 每个值恰好出现一次，同一消费者看到的同一生产者的序号递增。
+// 生产者全部结束后放入每个消费者一个结束标记
+template <bool Blocking>
+static bool test_mpmc_queue_stress() {
+    const uint64_t producers = 3, consumers = 3, per_producer = 200000;
+    const uint64_t stop = ~uint64_t(0);
+    mystl::mpmc_queue<uint64_t, Blocking> q(64);
+    std::unique_ptr<std::atomic<unsigned char>[]> seen(
+        new std::atomic<unsigned char>[producers * per_producer]);
+    for (uint64_t i = 0; i < producers * per_producer; ++i) seen[i] = 0;
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> threads;
+    for (uint64_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            uint64_t last[3] = {0, 0, 0};
+            for (;;) {
+                uint64_t v;
+                if (c == 0) {
+                    while (!q.try_pop(v)) std::this_thread::yield();
+                } else {
+                    q.pop(v);
+                }
+                if (v == stop) break;
+                const uint64_t p = v >> 32, seq = v & 0xffffffffu;
+                if (p >= producers || seq >= per_producer ||
+                    seq + 1 <= last[p] ||
+                    seen[p * per_producer + seq].exchange(1) != 0) {
+                    ok = false;
+                }
+                last[p] = seq + 1;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (uint64_t p = 0; p < producers; ++p) {
+        writers.emplace_back([&, p] {
+            for (uint64_t seq = 0; seq < per_producer; ++seq) {
+                const uint64_t v = p << 32 | seq;
+                if (p == 0) {
+                    while (!q.try_push(v)) std::this_thread::yield();
+                } else {
+                    q.push(v);
+                }
+            }
+        });
+    }
+    for (auto &t : writers) t.join();
+    for (uint64_t c = 0; c < consumers; ++c) q.push(stop);
+    for (auto &t : threads) t.join();
+    for (uint64_t i = 0; i < producers * per_producer; ++i) {
+        if (seen[i] != 1) ok = false;
+    }
+    return ok && q.empty();
+}
+
+// work_stealing_deque：所有者从很小的容量开始成批压入并弹出一部分，
+// 迫使数组多次扩容；三个窃取者同时窃取，每个值恰好被取走一次
+static bool test_work_stealing_deque_stress() {
+    const int64_t n = 1000000;
+    const int thieves = 3;
+    mystl::work_stealing_deque<int64_t> dq(2);
+    std::unique_ptr<std::atomic<unsigned char>[]> taken(
+        new std::atomic<unsigned char>[n]);
+    for (int64_t i = 0; i < n; ++i) taken[i] = 0;
+    std::atomic<bool> done(false);
+    std::atomic<bool> ok(true);
+    auto take = [&](int64_t v) {
+        if (v < 0 || v >= n || taken[v].exchange(1) != 0) ok = false;
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thieves; ++i) {
+        threads.emplace_back([&] {
+            int64_t v;
+            while (!done.load(std::memory_order_acquire) || !dq.empty()) {
+                if (dq.steal(v)) {
+                    take(v);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    int64_t next = 0, v;
+    while (next < n) {
+        const int64_t burst = 1 + next % 97;
+        for (int64_t k = 0; k < burst && next < n; ++k) dq.push(next++);
+        for (int64_t k = 0; k < burst / 2; ++k) {
+            if (dq.pop(v)) take(v);
+        }
+    }
+    while (dq.pop(v)) take(v);
+    done.store(true, std::memory_order_release);
+    for (auto &t : threads) t.join();
+    for (int64_t i = 0; i < n; ++i) {
+        if (taken[i] != 1) ok = false;
+    }
+    return ok && dq.empty();
+}
+
+// list：随机操作与std::list对照，每步之后检查size()和正反两个方向的内容。
+// 元素只按key比较，seq用来区分相等元素，检验unique保留每段的第一个、
+// sort稳定；splice的各种形式(整表、单个、跨表区间、同表区间、带n)
+// 都会改变两个链表的元素个数
+struct list_item {
+    int key;
+    int seq;
+    bool operator==(const list_item &rhs) const { return key == rhs.key; }
+    bool operator<(const list_item &rhs) const { return key < rhs.key; }
+};
+
+static bool same_list(const mystl::list<list_item> &l,
+                      const std::list<list_item> &s) {
+    if (l.size() != s.size() || l.empty() != s.empty()) return false;
+    auto it = l.begin();
+    for (const auto &x : s) {
+        if (it == l.end() || it->key != x.key || it->seq != x.seq) return false;
+        ++it;
+    }
+    if (it != l.end()) return false;
+    auto rit = s.rbegin();
+    for (auto b = l.end(); b != l.begin(); ++rit) {
+        --b;
+        if (b->seq != rit->seq) return false;
+    }
+    return true;
+}
+
+template <class Iterator>
+static Iterator list_at(Iterator it, size_t n) {
+    for (; n > 0; --n) ++it;
+    return it;
+}
+
+static bool test_list_differential() {
+    bool ok = true;
+    std::mt19937 rng(11);
+    mystl::list<list_item> l[2];
+    std::list<list_item> s[2];
+    int seq = 0;
+    auto item = [&] { return list_item{static_cast<int>(rng() % 8), seq++}; };
+    for (int step = 0; step < 40000; ++step) {
+        const int a = static_cast<int>(rng() % 2), b = 1 - a;
+        const size_t n = s[a].size();
+        const size_t i = rng() % (n + 1), j = i + rng() % (n - i + 1);
+        switch (rng() % 16) {
+            case 0:
+            case 1: {
+                const list_item x = item();
+                l[a].push_back(x);
+                s[a].push_back(x);
+                const list_item y = item();
+                l[a].push_front(y);
+                s[a].push_front(y);
+                break;
+            }
+            case 2: {
+                const list_item x = item();
+                const size_t k = rng() % 4;
+                l[a].insert(list_at(l[a].begin(), i), k, x);
+                s[a].insert(list_at(s[a].begin(), i), k, x);
+                break;
+            }
+            case 3:
+                if (i < n) {
+                    auto r = l[a].erase(list_at(l[a].begin(), i));
+                    auto e = s[a].erase(list_at(s[a].begin(), i));
+                    if ((r == l[a].end()) != (e == s[a].end()) ||
+                        (e != s[a].end() && r->seq != e->seq)) {
+                        ok = false;
+                    }
+                }
+                break;
+            case 4: {
+                auto r = l[a].erase(list_at(l[a].begin(), i),
+                                    list_at(l[a].begin(), j));
+                auto e = s[a].erase(list_at(s[a].begin(), i),
+                                    list_at(s[a].begin(), j));
+                if ((r == l[a].end()) != (e == s[a].end()) ||
+                    (e != s[a].end() && r->seq != e->seq)) {
+                    ok = false;
+                }
+                break;
+            }
+            case 5: {
+                const list_item x = item();
+                l[a].remove(x);
+                s[a].remove(x);
+                break;
+            }
+            case 6:
+                l[a].unique();
+                s[a].unique();
+                break;
+            case 7:
+                l[a].reverse();
+                s[a].reverse();
+                break;
+            case 8: {
+                const size_t pos = rng() % (s[b].size() + 1);
+                l[b].splice(list_at(l[b].begin(), pos), l[a]);
+                s[b].splice(list_at(s[b].begin(), pos), s[a]);
+                break;
+            }
+            case 9:
+                if (i < n) {
+                    // 一半跨表，一半在同一个链表内移动
+                    const int to = rng() % 2 ? b : a;
+                    const size_t pos = rng() % (s[to].size() + 1);
+                    l[to].splice(list_at(l[to].begin(), pos), l[a],
+                                 list_at(l[a].begin(), i));
+                    s[to].splice(list_at(s[to].begin(), pos), s[a],
+                                 list_at(s[a].begin(), i));
+                }
+                break;
+            case 10: {
+                const size_t pos = rng() % (s[b].size() + 1);
+                if (rng() % 2) {
+                    l[b].splice(list_at(l[b].begin(), pos), l[a],
+                                list_at(l[a].begin(), i),
+                                list_at(l[a].begin(), j));
+                } else {
+                    l[b].splice(list_at(l[b].begin(), pos), l[a],
+                                list_at(l[a].begin(), i),
+                                list_at(l[a].begin(), j), j - i);
+                }
+                s[b].splice(list_at(s[b].begin(), pos), s[a],
+                            list_at(s[a].begin(), i), list_at(s[a].begin(), j));
+                break;
+            }
+            case 11: {
+                // 同一链表内的区间，插入位置不能在[i, j)中
+                size_t pos = rng() % (n + 1);
+                if (pos >= i && pos < j) pos = j;
+                l[a].splice(list_at(l[a].begin(), pos), l[a],
+                            list_at(l[a].begin(), i), list_at(l[a].begin(), j));
+                s[a].splice(list_at(s[a].begin(), pos), s[a],
+                            list_at(s[a].begin(), i), list_at(s[a].begin(), j));
+                break;
+            }
+            case 12:
+                l[a].sort();
+                s[a].sort();
+                break;
+            case 13:
+                l[a].sort();
+                s[a].sort();
+                l[b].sort();
+                s[b].sort();
+                l[a].merge(l[b]);
+                s[a].merge(s[b]);
+                break;
+            case 14: {
+                const size_t k = rng() % 40;
+                const list_item x = item();
+                l[a].resize(k, x);
+                s[a].resize(k, x);
+                break;
+            }
+            default:
+                if (rng() % 4 == 0) {
+                    l[a] = l[b];
+                    s[a] = s[b];
+                } else if (n > 200) {
+                    l[a].clear();
+                    s[a].clear();
+                } else {
+                    l[a].linearize();
+                }
+                break;
+        }
+        if (!same_list(l[0], s[0]) || !same_list(l[1], s[1])) {
+            ok = false;
+            break;
+        }
+    }
+
+    // 大小跨过数组排序阈值的稳定性
+    for (size_t n : {10, 255, 256, 5000}) {
+        mystl::list<list_item> ls;
+        std::list<list_item> ss;
+        for (size_t k = 0; k < n; ++k) {
+            const list_item x = item();
+            ls.push_back(x);
+            ss.push_back(x);
+        }
+        ls.sort();
+        ss.sort();
+        if (!same_list(ls, ss)) ok = false;
+    }
+    return ok;
+}
+
+// circular_buffer：随机操作与std::deque对照。元素用超出短字符串优化的
+// std::string，搬迁或别名处理出错时内容会变；另外单独构造环绕、
+// 环绕状态下扩容、push_n/pop_n跨越接缝、以及满时追加容器自身元素的情形
+static bool test_circular_buffer_differential() {
+    using buffer = mystl::circular_buffer<std::string>;
+    bool ok = true;
+    auto value = [](size_t i) {
+        return "circular_buffer element " + std::to_string(i);
+    };
+    auto same = [](const buffer &b, const std::deque<std::string> &d) {
+        if (b.size() != d.size() || b.empty() != d.empty()) return false;
+        if (b.size() > b.capacity()) return false;
+        for (size_t i = 0; i < d.size(); ++i) {
+            if (b[i] != d[i]) return false;
+        }
+        return std::equal(d.begin(), d.end(), b.begin());
+    };
+
+    {
+        // 容量8，先取走5个再追加，尾部绕回数组开头
+        buffer b;
+        std::deque<std::string> d;
+        b.reserve(8);
+        for (size_t i = 0; i < 8; ++i) {
+            b.push_back(value(i));
+            d.push_back(value(i));
+        }
+        for (int i = 0; i < 5; ++i) {
+            b.pop_front();
+            d.pop_front();
+        }
+        for (size_t i = 8; i < 13; ++i) {
+            b.push_back(value(i));
+            d.push_back(value(i));
+        }
+        if (!same(b, d) || b.capacity() != 8) ok = false;
+        // 环绕且满时追加引用自身元素的值，随后扩容
+        b.emplace_back(b.front());
+        d.push_back(d.front());
+        b.push_back(b[3]);
+        d.push_back(d[3]);
+        if (!same(b, d) || b.capacity() != 16) ok = false;
+        // push_n跨越接缝：先让头部靠近数组末尾
+        for (int i = 0; i < 6; ++i) {
+            b.pop_front();
+            d.pop_front();
+        }
+        std::vector<std::string> src;
+        for (size_t i = 100; i < 110; ++i) src.push_back(value(i));
+        b.push_n(src.begin(), src.size());
+        d.insert(d.end(), src.begin(), src.end());
+        if (!same(b, d)) ok = false;
+        std::vector<std::string> out(b.size());
+        const size_t got = b.pop_n(out.begin(), 10);
+        if (got != 10 || !std::equal(out.begin(), out.begin() + 10, d.begin()))
+            ok = false;
+        d.erase(d.begin(), d.begin() + 10);
+        if (!same(b, d)) ok = false;
+        b.shrink_to_fit();
+        if (!same(b, d) || b.capacity() != 4) ok = false;
+        // 收缩后正好满，在头部插入自身元素
+        b.emplace_front(b.back());
+        d.push_front(d.back());
+        if (!same(b, d)) ok = false;
+    }
+
+    buffer b;
+    std::deque<std::string> d;
+    std::mt19937 rng(7);
+    for (int step = 0; step < 100000; ++step) {
+        const size_t k = rng() % 1000;
+        switch (rng() % 10) {
+            case 0:
+            case 1:
+                b.push_back(value(k));
+                d.push_back(value(k));
+                break;
+            case 2:
+                b.push_front(value(k));
+                d.push_front(value(k));
+                break;
+            case 3:
+                if (!d.empty()) {
+                    b.pop_front();
+                    d.pop_front();
+                }
+                break;
+            case 4:
+                if (!d.empty()) {
+                    b.pop_back();
+                    d.pop_back();
+                }
+                break;
+            case 5: {
+                std::vector<std::string> src;
+                for (size_t i = rng() % 40; i > 0; --i) src.push_back(value(i));
+                b.push_n(src.begin(), src.size());
+                d.insert(d.end(), src.begin(), src.end());
+                break;
+            }
+            case 6: {
+                std::vector<std::string> out(rng() % 40);
+                const size_t got = b.pop_n(out.begin(), out.size());
+                const size_t want = out.size() < d.size() ? out.size() : d.size();
+                if (got != want ||
+                    !std::equal(out.begin(), out.begin() + got, d.begin())) {
+                    ok = false;
+                }
+                d.erase(d.begin(), d.begin() + want);
+                break;
+            }
+            case 7:
+                if (!d.empty()) {
+                    const size_t i = rng() % d.size();
+                    if (rng() % 2) {
+                        b.emplace_back(b[i]);
+                        d.push_back(std::string(d[i]));
+                    } else {
+                        b.emplace_front(b[i]);
+                        d.push_front(std::string(d[i]));
+                    }
+                }
+                break;
+            case 8:
+                if (step % 16 == 0) b.shrink_to_fit();
+                break;
+            default:
+                if (step % 997 == 0) {
+                    b.clear();
+                    d.clear();
+                } else if (!d.empty()) {
+                    const size_t pos = rng() % d.size();
+                    const size_t n = rng() % (d.size() - pos + 1);
+                    std::vector<std::string> out;
+                    b.copy_out(pos, n, std::back_inserter(out));
+                    if (!std::equal(out.begin(), out.end(), d.begin() + pos) ||
+                        out.size() != n) {
+                        ok = false;
+                    }
+                }
+                break;
+        }
+        if (step % 64 == 0 && !same(b, d)) ok = false;
+    }
+    if (!same(b, d)) ok = false;
+    buffer copy(b);
+    if (!(copy == b) || !same(copy, d)) ok = false;
+    return ok;
+}
+
+// queue的默认底层容器是circular_buffer：交替入队出队，顺序先进先出
+static bool test_queue_fifo() {
+    mystl::queue<int> q;
+    int next_in = 0, next_out = 0;
+    bool ok = true;
+    for (int round = 0; round < 1000; ++round) {
+        for (int i = round % 37; i > 0; --i) q.push(next_in++);
+        for (int i = round % 29; i > 0 && !q.empty(); --i) {
+            if (q.front() != next_out++) ok = false;
+            q.pop();
+        }
+        if (!q.empty() && q.back() != next_in - 1) ok = false;
+        if (static_cast<int>(q.size()) != next_in - next_out) ok = false;
+    }
+    while (!q.empty()) {
+        if (q.front() != next_out++) ok = false;
+        q.pop();
+    }
+    return ok && next_out == next_in;
+}
+
+// concurrent_skip_list：单线程随机操作，与std::map/std::set逐步对照
+static bool test_concurrent_skip_list_differential() {
+    bool ok = true;
+    std::mt19937 rng(42);
+    mystl::concurrent_skip_list_map<int, int> m;
+    std::map<int, int> ref;
+    auto same = [&] {
+        if (m.size() != ref.size() || m.empty() != ref.empty()) return false;
+        auto it = m.begin();
+        for (const auto &kv : ref) {
+            if (it == m.end() || it->first != kv.first ||
+                it->second != kv.second) {
+                return false;
+            }
+            ++it;
+        }
+        return it == m.end();
+    };
+    for (int step = 0; step < 200000; ++step) {
+        const int k = static_cast<int>(rng() % 512);
+        const int v = static_cast<int>(rng());
+        switch (rng() % 8) {
+            case 0: {
+                auto r = m.insert(mystl::pair<const int, int>(k, v));
+                auto e = ref.insert(std::make_pair(k, v));
+                if (r.second != e.second || r.first->second != e.first->second)
+                    ok = false;
+                break;
+            }
+            case 1: {
+                auto r = m.emplace(k, v);
+                auto e = ref.emplace(k, v);
+                if (r.second != e.second || r.first->second != e.first->second)
+                    ok = false;
+                break;
+            }
+            case 2:
+                if (m.erase(k) != ref.erase(k)) ok = false;
+                break;
+            case 3: {
+                auto it = m.find(k);
+                auto e = ref.find(k);
+                if ((it == m.end()) != (e == ref.end())) {
+                    ok = false;
+                } else if (e != ref.end()) {
+                    if (it->second != e->second || !m.erase(it)) ok = false;
+                    ref.erase(e);
+                }
+                break;
+            }
+            case 4: {
+                auto it = m.lower_bound(k);
+                auto e = ref.lower_bound(k);
+                if ((it == m.end()) != (e == ref.end()) ||
+                    (e != ref.end() && it->first != e->first)) {
+                    ok = false;
+                }
+                break;
+            }
+            case 5: {
+                auto it = m.upper_bound(k);
+                auto e = ref.upper_bound(k);
+                if ((it == m.end()) != (e == ref.end()) ||
+                    (e != ref.end() && it->first != e->first)) {
+                    ok = false;
+                }
+                break;
+            }
+            case 6:
+                if (m.contains(k) != (ref.count(k) != 0) ||
+                    m.count(k) != ref.count(k)) {
+                    ok = false;
+                }
+                break;
+            default:
+                if (step % 1000 == 7) {
+                    m.clear();
+                    ref.clear();
+                }
+                break;
+        }
+        if (step % 4096 == 0 && !same()) ok = false;
+    }
+    if (!same()) ok = false;
+
+    mystl::concurrent_skip_list_set<int> s;
+    std::set<int> sref;
+    for (int step = 0; step < 100000; ++step) {
+        const int k = static_cast<int>(rng() % 2048);
+        if (rng() % 3 == 0) {
+            if (s.erase(k) != sref.erase(k)) ok = false;
+        } else if (s.insert(k).second != sref.insert(k).second) {
+            ok = false;
+        }
+    }
+    if (s.size() != sref.size() ||
+        !std::equal(sref.begin(), sref.end(), s.begin())) {
+        ok = false;
+    }
+    return ok;
+}
+
+// 统计存活个数，检查节点确实被回收
+struct skip_list_counted {
+    static std::atomic<int> live;
+    int v;
+    skip_list_counted(int x) : v(x) { ++live; }
+    skip_list_counted(const skip_list_counted &rhs) : v(rhs.v) { ++live; }
+    ~skip_list_counted() { --live; }
+    bool operator<(const skip_list_counted &rhs) const { return v < rhs.v; }
+};
+std::atomic<int> skip_list_counted::live(0);
+
+// 默认构造的迭代器和end()不持有epoch，拿着它们时删除的节点仍能被回收
+static bool test_concurrent_skip_list_end_iterator() {
+    bool ok = true;
+    {
+        mystl::concurrent_skip_list_set<skip_list_counted> s;
+        mystl::concurrent_skip_list_set<skip_list_counted>::iterator held;
+        auto end = s.end();
+        held = s.end();
+        for (int i = 0; i < 100000; ++i) {
+            s.insert(skip_list_counted(i));
+            s.erase(skip_list_counted(i));
+        }
+        if (skip_list_counted::live > 10000) ok = false;
+        // 走到end()的迭代器同样放开epoch
+        s.insert(skip_list_counted(1));
+        auto it = s.begin();
+        ++it;
+        if (it != end || held != end) ok = false;
+        for (int i = 2; i < 100000; ++i) {
+            s.insert(skip_list_counted(i));
+            s.erase(skip_list_counted(i));
+        }
+        if (skip_list_counted::live > 10000) ok = false;
+    }
+    return ok;
+}
+
+// concurrent_skip_list：8个线程并发。第一阶段每个线程只增删自己的键
+// (k % 8 == 线程号)并在本地记账，同时查找和遍历整个表，遍历必须严格递增；
+// 结束后表中内容等于各线程记账的并集。第二阶段所有线程以不同顺序
+// 删除全部键，每个键恰好被删除成功一次
+static bool test_concurrent_skip_list_stress() {
+    const int threads = 8, keys = 4096, ops = 40000;
+    mystl::concurrent_skip_list_map<int, int> m;
+    std::vector<std::set<int>> owned(threads);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            std::set<int> &mine = owned[t];
+            for (int i = 0; i < ops; ++i) {
+                const int k = static_cast<int>(rng() % (keys / threads)) *
+                                  threads + t;
+                switch (rng() % 6) {
+                    case 0:
+                    case 1:
+                        if (m.insert(mystl::pair<const int, int>(k, t))
+                                .second != mine.insert(k).second) {
+                            ok = false;
+                        }
+                        break;
+                    case 2:
+                        if (m.erase(k) != mine.erase(k)) ok = false;
+                        break;
+                    case 3: {
+                        auto it = m.find(k);
+                        if ((it != m.end()) != (mine.count(k) != 0) ||
+                            (it != m.end() && it->second != t)) {
+                            ok = false;
+                        }
+                        break;
+                    }
+                    case 4: {
+                        auto it = m.lower_bound(static_cast<int>(rng() % keys));
+                        if (it != m.end() && it->second != it->first % threads)
+                            ok = false;
+                        break;
+                    }
+                    default:
+                        if (i % 64 == 0) {
+                            int last = -1;
+                            for (auto it = m.begin(); it != m.end(); ++it) {
+                                if (it->first <= last) ok = false;
+                                last = it->first;
+                            }
+                        }
+                        break;
+                }
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    workers.clear();
+    std::set<int> expect;
+    for (const auto &mine : owned) expect.insert(mine.begin(), mine.end());
+    {
+        auto it = m.begin();
+        for (int k : expect) {
+            if (it == m.end() || it->first != k) {
+                ok = false;
+                break;
+            }
+            ++it;
+        }
+        if (it != m.end() || m.size() != expect.size()) ok = false;
+    }
+
+    for (int k = 0; k < keys; ++k) m.insert(mystl::pair<const int, int>(k, 0));
+    std::unique_ptr<std::atomic<int>[]> erased(new std::atomic<int>[keys]);
+    for (int k = 0; k < keys; ++k) erased[k] = 0;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < keys; ++i) {
+                const int k = (i * 7 + t * (keys / threads)) % keys;
+                erased[k] += static_cast<int>(m.erase(k));
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    for (int k = 0; k < keys; ++k) {
+        if (erased[k] != 1) ok = false;
+    }
+    return ok && m.empty() && m.size() == 0;
+}
+
+// timer_wheel：随机调度、取消、推进，与逐个扫描全部定时器的参考模型对照。
+// 模型里到期顺序为(到期时间, 调度次序)，回调中按同样的随机决定
+// 重新调度自己(包括已经过去的时刻)、取消其他定时器或抛出异常，两边同步执行。
+// 抛出异常后同批其余定时器仍在调度中，下一次advance最先回调
+struct wheel_timer : mystl::timer_wheel_entry {
+    int id;
+};
+
+template <size_t Levels>
+static bool test_timer_wheel_reference(uint64_t start, int delay_bits) {
+    const int timers = 256;
+    struct model_entry {
+        bool scheduled = false;
+        uint64_t expires = 0;
+        uint64_t seq = 0;
+    };
+    mystl::timer_wheel<wheel_timer, Levels> wheel(start);
+    std::vector<wheel_timer> t(timers);
+    std::vector<model_entry> model(timers);
+    uint64_t now = start, seq = 0;
+    std::mt19937_64 rng(Levels * 1000 + delay_bits);
+    bool ok = true;
+
+    auto random_delay = [&]() -> uint64_t {
+        const uint64_t d = rng() >> (64 - delay_bits);
+        return d >> (rng() % delay_bits);
+    };
+    auto schedule = [&](int id, uint64_t expires) {
+        wheel.schedule(t[id], expires);
+        model[id].scheduled = true;
+        model[id].expires = expires > now ? expires : now + 1;
+        model[id].seq = seq++;
+    };
+    auto cancel = [&](int id) {
+        if (wheel.cancel(t[id]) != model[id].scheduled) ok = false;
+        model[id].scheduled = false;
+    };
+    // 模型中下一个不晚于limit到期的定时器
+    auto next_due = [&](uint64_t limit) {
+        int best = -1;
+        for (int i = 0; i < timers; ++i) {
+            const model_entry &m = model[i];
+            if (!m.scheduled || m.expires > limit) continue;
+            if (best < 0 || m.expires < model[best].expires ||
+                (m.expires == model[best].expires && m.seq < model[best].seq)) {
+                best = i;
+            }
+        }
+        return best;
+    };
+
+    {
+        // 同一tick的三个定时器，第一个回调抛出异常
+        mystl::timer_wheel<wheel_timer, Levels> w(start);
+        wheel_timer x[3];
+        for (int i = 0; i < 3; ++i) {
+            x[i].id = i;
+            w.schedule(x[i], start + 5);
+        }
+        try {
+            w.advance(start + 10, [](wheel_timer &) { throw 0; });
+            ok = false;
+        } catch (int) {
+        }
+        if (x[0].is_scheduled() || !x[1].is_scheduled() ||
+            !x[2].is_scheduled() || w.now() != start + 5 ||
+            w.next_expiry() != start + 5 || w.empty()) {
+            ok = false;
+        }
+        int order = 1;
+        if (w.advance(start + 20, [&](wheel_timer &y) {
+                if (y.id != order++) ok = false;
+            }) != 2 ||
+            !w.empty()) {
+            ok = false;
+        }
+    }
+
+    for (int i = 0; i < timers; ++i) {
+        t[i].id = i;
+        if (i % 3 != 0) schedule(i, now + random_delay());
+    }
+    for (int round = 0; round < 3000 && ok; ++round) {
+        for (int k = 0; k < 4; ++k) {
+            const int id = static_cast<int>(rng() % timers);
+            switch (rng() % 4) {
+                case 0:
+                    cancel(id);
+                    break;
+                case 1:
+                    // 已经过去的时刻
+                    schedule(id, now - rng() % (now + 1));
+                    break;
+                default:
+                    schedule(id, now + random_delay());
+                    break;
+            }
+        }
+        uint64_t target = now + 1 + rng() % 100;
+        if (round % 10 == 0) {
+            // 直接跳到某个较远的到期时间
+            const int id = static_cast<int>(rng() % timers);
+            if (model[id].scheduled && model[id].expires > target) {
+                target = model[id].expires;
+            }
+        }
+        size_t expected = 0, fired = 0;
+        bool thrown = false;
+        auto callback = [&](wheel_timer &x) {
+            const int want = next_due(target);
+            if (want != x.id || wheel.now() != model[want].expires) {
+                ok = false;
+                return;
+            }
+            ++expected;
+            now = wheel.now();
+            model[want].scheduled = false;
+            if (x.is_scheduled()) ok = false;
+            const uint64_t action = rng() % 8;
+            if (action < 3) {
+                schedule(x.id, now + (action == 0 ? 0 : random_delay()));
+            } else if (action == 3) {
+                schedule(x.id, now - rng() % (now + 1));
+            } else if (action == 4) {
+                cancel(static_cast<int>(rng() % timers));
+            } else if (action == 5 && rng() % 4 == 0) {
+                throw round;
+            }
+        };
+        try {
+            fired = wheel.advance(target, callback);
+            now = target;
+        } catch (int) {
+            thrown = true;
+        }
+        if (wheel.now() != now ||
+            (!thrown && (fired != expected || next_due(target) >= 0))) {
+            ok = false;
+        }
+        for (int i = 0; i < timers; ++i) {
+            if (t[i].is_scheduled() != model[i].scheduled) ok = false;
+        }
+        const int first = next_due(~uint64_t(0));
+        const uint64_t next = wheel.next_expiry();
+        if (first < 0) {
+            if (next != wheel.no_expiry) ok = false;
+        } else if (model[first].expires <= now
+                       ? next != now
+                       : (next <= now || next > model[first].expires)) {
+            ok = false;
+        }
+    }
+    wheel.clear();
+    for (int i = 0; i < timers; ++i) {
+        if (t[i].is_scheduled()) ok = false;
+    }
+    return ok && wheel.empty();
+}
+
 int main() {
     // 创建一个 rb_tree 实例
     mystl::rb_tree<int, std::less<int>> tree;
@@ -121,5 +1033,26 @@ int main() {
     std::cout << "Multimap empty: " << (mmap.empty() ? "Yes" : "No")
               << std::endl;
 
-    return 0;
+    // 并发容器
+    report("spsc_queue stress", test_spsc_queue_stress());
+    report("mpmc_queue stress (blocking)", test_mpmc_queue_stress<true>());
+    report("mpmc_queue stress (spinning)", test_mpmc_queue_stress<false>());
+    report("work_stealing_deque stress", test_work_stealing_deque_stress());
+    report("circular_buffer vs std::deque", test_circular_buffer_differential());
+    report("queue FIFO", test_queue_fifo());
+    report("list vs std::list", test_list_differential());
+    report("concurrent_skip_list vs std::map",
+           test_concurrent_skip_list_differential());
+    report("concurrent_skip_list end iterator",
+           test_concurrent_skip_list_end_iterator());
+    report("concurrent_skip_list stress", test_concurrent_skip_list_stress());
+    report("timer_wheel<1> vs reference", test_timer_wheel_reference<1>(0, 12));
+    report("timer_wheel<2> vs reference",
+           test_timer_wheel_reference<2>(4000, 16));
+    report("timer_wheel<6> vs reference",
+           test_timer_wheel_reference<6>(123456, 40));
+    report("timer_wheel<10> vs reference",
+           test_timer_wheel_reference<10>(uint64_t(1) << 40, 62));
+
+    return all_passed ? 0 : 1;
 }
\ No newline at end of file
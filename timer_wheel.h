@@ -0,0 +1,246 @@
+#pragma once
+
+// 分层时间轮(hashed hierarchical timing wheel)
+// 时间以整数tick表示。每层64个槽，第l层一个槽覆盖64^l个tick，
+// 定时器按到期时间与当前时间最高的不同位所在的层放入对应的槽。
+// 槽是侵入式链表，定时器对象自己带钩子，调度和取消都是O(1)且不分配内存：
+// 调度是一次链表插入，取消是一次摘除(定时器析构时也会自动摘除)。
+// 时间推进到第l层某个槽的起点时，把整槽摘下来重新放入更低的层(级联)；
+// 到达第0层的槽时整槽一次摘下，依次调用回调(批量到期)。
+// 每层有一个非空槽位图，advance跳过空槽，推进一大段时间的代价与
+// 实际经过的非空槽数量有关，而不是与tick数有关。
+// 超出最高层范围的定时器放在溢出链表里，最高层每转一圈重新放置一次。
+// 回调抛出异常时，同批中尚未回调的定时器留在到期链表里，仍处于调度中，
+// 下一次advance最先回调它们。
+// 不是线程安全的，通常每个事件循环线程一个时间轮。
+
+#include <cstddef>
+#include <cstdint>
+
+#include "exceptdef.h"
+#include "intrusive_list.h"
+#include "simd.h"
+
+namespace mystl {
+struct timer_wheel_tag {};
+
+// 要调度的对象继承timer_wheel_entry
+class timer_wheel_entry
+    : public intrusive_list_hook<timer_wheel_tag, link_mode::auto_unlink> {
+    template <class, size_t>
+    friend class timer_wheel;
+
+   public:
+    using hook_type =
+        intrusive_list_hook<timer_wheel_tag, link_mode::auto_unlink>;
+
+    // 最近一次调度时给出的到期时间
+    uint64_t expiry() const { return expires; }
+    bool is_scheduled() const { return is_linked(); }
+    // 不需要时间轮本身就可以取消
+    void cancel() { hook_type::unlink(); }
+
+   private:
+    uint64_t expires = 0;
+};
+
+template <class T, size_t Levels = 6>
+class timer_wheel {
+    static_assert(Levels >= 1 && Levels * 6 < 64,
+                  "timer_wheel supports 1 to 10 levels");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using tick_type = uint64_t;
+
+    static constexpr size_t slot_bits = 6;
+    static constexpr size_t slots_per_level = size_t(1) << slot_bits;
+    static constexpr size_t levels = Levels;
+    static constexpr tick_type no_expiry = ~tick_type(0);
+
+   private:
+    using hook_type = timer_wheel_entry::hook_type;
+    using bucket_type = intrusive_list<T, hook_type>;
+
+    tick_type current;
+    bucket_type buckets[Levels][slots_per_level];
+    // 置位的槽可能已经因取消而变空，用到时再清除
+    uint64_t occupied[Levels];
+    bucket_type overflow;
+    // 已经到期、正在或等待回调的定时器
+    bucket_type due;
+
+    static size_t digit(tick_type t, size_t level) {
+        return static_cast<size_t>(t >> (slot_bits * level)) &
+               (slots_per_level - 1);
+    }
+
+    // 放入与当前时间最高的不同位所在的层，e不早于current
+    void place(T &x, tick_type e) {
+        tick_type diff = e ^ current;
+        size_t level = 0;
+        while (level < Levels && (diff >> (slot_bits * (level + 1))) != 0) {
+            ++level;
+        }
+        if (level == Levels) {
+            overflow.push_back(x);
+            return;
+        }
+        size_t slot = digit(e, level);
+        buckets[level][slot].push_back(x);
+        occupied[level] |= uint64_t(1) << slot;
+    }
+
+    // 第level层在当前时间之后的第一个非空槽的起点，没有返回no_expiry
+    tick_type next_in_level(size_t level) {
+        size_t d = digit(current, level);
+        uint64_t bits = d + 1 == slots_per_level
+                            ? 0
+                            : occupied[level] & (~uint64_t(0) << (d + 1));
+        while (bits) {
+            size_t slot = simd::ctz64(bits);
+            if (!buckets[level][slot].empty()) {
+                size_t shift = slot_bits * (level + 1);
+                tick_type base = current & ~((tick_type(1) << shift) - 1);
+                return base | (tick_type(slot) << (slot_bits * level));
+            }
+            occupied[level] &= ~(uint64_t(1) << slot);
+            bits &= bits - 1;
+        }
+        return no_expiry;
+    }
+
+    // 下一个需要处理的时刻：某层非空槽的起点，或溢出链表的重新放置点
+    tick_type next_event() {
+        tick_type next = no_expiry;
+        for (size_t level = 0; level < Levels; ++level) {
+            tick_type t = next_in_level(level);
+            if (t < next) next = t;
+        }
+        if (!overflow.empty()) {
+            size_t shift = slot_bits * Levels;
+            tick_type t = ((current >> shift) + 1) << shift;
+            if (t < next) next = t;
+        }
+        return next;
+    }
+
+    // 把整个链表重新放置，其中的定时器都不早于current到期
+    void replace_all(bucket_type &from) {
+        bucket_type pending;
+        pending.splice(pending.end(), from);
+        while (!pending.empty()) {
+            T &x = pending.front();
+            pending.pop_front();
+            tick_type e = static_cast<timer_wheel_entry &>(x).expires;
+            place(x, e < current ? current : e);
+        }
+    }
+
+    // current刚刚到达t：从高到低级联在t处开始的槽，再让第0层的槽到期
+    template <class Function>
+    size_type process(Function &f) {
+        size_t shift = slot_bits * Levels;
+        if ((current & ((tick_type(1) << shift) - 1)) == 0) {
+            replace_all(overflow);
+        }
+        for (size_t level = Levels - 1; level >= 1; --level) {
+            if ((current & ((tick_type(1) << (slot_bits * level)) - 1)) != 0) {
+                continue;
+            }
+            size_t slot = digit(current, level);
+            occupied[level] &= ~(uint64_t(1) << slot);
+            replace_all(buckets[level][slot]);
+        }
+        size_t slot = digit(current, 0);
+        occupied[0] &= ~(uint64_t(1) << slot);
+        due.splice(due.end(), buckets[0][slot]);
+        return fire_due(f);
+    }
+
+    // 依次回调due中的定时器。回调里可以重新调度x，也可以取消同批中
+    // 尚未回调的其他定时器；回调抛出异常时其余定时器留在due中
+    template <class Function>
+    size_type fire_due(Function &f) {
+        size_type n = 0;
+        while (!due.empty()) {
+            T &x = due.front();
+            due.pop_front();
+            ++n;
+            f(x);
+        }
+        return n;
+    }
+
+   public:
+    explicit timer_wheel(tick_type now = 0) : current(now) {
+        for (size_t level = 0; level < Levels; ++level) occupied[level] = 0;
+    }
+    timer_wheel(const timer_wheel &) = delete;
+    timer_wheel &operator=(const timer_wheel &) = delete;
+
+    // 析构时所有定时器被摘除(不析构)
+    ~timer_wheel() = default;
+
+    tick_type now() const { return current; }
+
+    // 在expires时刻到期；已经过去的时刻视为下一个tick。
+    // 已调度的定时器会先被取消
+    void schedule(T &x, tick_type expires) {
+        timer_wheel_entry &entry = x;
+        entry.cancel();
+        entry.expires = expires;
+        place(x, expires > current ? expires : current + 1);
+    }
+
+    void schedule_after(T &x, tick_type delay) {
+        schedule(x, current + (delay == 0 ? 1 : delay));
+    }
+
+    // 返回定时器原先是否处于调度中
+    bool cancel(T &x) {
+        timer_wheel_entry &entry = x;
+        bool scheduled = entry.is_scheduled();
+        entry.cancel();
+        return scheduled;
+    }
+
+    // 把时间推进到now，按到期时间顺序对到期的定时器调用f(T&)，
+    // 同一tick到期的定时器按调度顺序回调。返回到期的个数。
+    // f抛出异常时时间停在当前批次的tick上，异常传给调用者
+    template <class Function>
+    size_type advance(tick_type now, Function f) {
+        size_type n = fire_due(f);
+        while (current < now) {
+            tick_type next = next_event();
+            if (next > now) {
+                current = now;
+                break;
+            }
+            current = next;
+            n += process(f);
+        }
+        return n;
+    }
+
+    // 不晚于最早到期时间的下一个处理时刻，事件循环可以据此决定休眠多久；
+    // 有因异常而未回调的定时器时返回now()，没有定时器时返回no_expiry
+    tick_type next_expiry() { return due.empty() ? next_event() : current; }
+
+    bool empty() { return due.empty() && next_event() == no_expiry; }
+
+    // 摘除所有定时器
+    void clear() {
+        for (size_t level = 0; level < Levels; ++level) {
+            for (size_t slot = 0; slot < slots_per_level; ++slot) {
+                buckets[level][slot].clear();
+            }
+            occupied[level] = 0;
+        }
+        overflow.clear();
+        due.clear();
+    }
+};
+
+}  // namespace mystl
@@ -1,10 +1,21 @@
 #pragma once
 
+#include <new>
+#include <type_traits>
+
+#include "algobase.h"
 #include "construct.h"
+#include "deque_iterator.h"
 #include "iterator.h"
 #include "type_traits.h"
 
 namespace mystl {
+// 默认初始化标签：构造或resize时不对平凡类型做值初始化
+struct default_init_t {
+    explicit default_init_t() = default;
+};
+constexpr default_init_t default_init{};
+
 template <typename InputIterator, typename ForwardIterator>
 ForwardIterator uninitialized_copy(InputIterator first, InputIterator last,
                                    ForwardIterator result, mystl::true_type) {
@@ -37,6 +48,41 @@ ForwardIterator uninitialized_copy(InputIterator first, InputIterator last,
         typename mystl::type_traits<value_type>::is_POD_type());
 }
 
+// uninitialized_move
+// 把[first, last)移动构造到result开始的未初始化空间，平凡类型退化为拷贝
+template <typename InputIterator, typename ForwardIterator>
+ForwardIterator uninitialized_move(InputIterator first, InputIterator last,
+                                   ForwardIterator result, mystl::true_type) {
+    return std::copy(first, last, result);
+}
+
+template <typename InputIterator, typename ForwardIterator>
+ForwardIterator uninitialized_move(InputIterator first, InputIterator last,
+                                   ForwardIterator result, mystl::false_type) {
+    ForwardIterator cur = result;
+    try {
+        for (; first != last; ++first, ++cur) {
+            mystl::construct(&*cur, std::move(*first));
+        }
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(result, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename InputIterator, typename ForwardIterator>
+ForwardIterator uninitialized_move(InputIterator first, InputIterator last,
+                                   ForwardIterator result) {
+    using value_type =
+        typename std::iterator_traits<ForwardIterator>::value_type;
+    return mystl::uninitialized_move(
+        first, last, result,
+        mystl::integral_constant<
+            bool, std::is_trivially_copyable<value_type>::value>());
+}
+
 template <typename ForwardIterator, typename T>
 void uninitialized_fill(ForwardIterator first, ForwardIterator last,
                         const T &value, mystl::true_type) {
@@ -69,19 +115,20 @@ void uninitialized_fill(ForwardIterator first, ForwardIterator last,
 }
 
 template <typename ForwardIterator, typename T>
-void uninitialized_fill_n(ForwardIterator first, size_t n, const T &value,
-                          mystl::true_type) {
-    std::fill_n(first, n, value);
+ForwardIterator uninitialized_fill_n(ForwardIterator first, size_t n,
+                                     const T &value, mystl::true_type) {
+    return std::fill_n(first, n, value);
 }
 
 template <typename ForwardIterator, typename T>
-void uninitialized_fill_n(ForwardIterator first, size_t n, const T &value,
-                          mystl::false_type) {
+ForwardIterator uninitialized_fill_n(ForwardIterator first, size_t n,
+                                     const T &value, mystl::false_type) {
     ForwardIterator cur = first;
     try {
         for (; n > 0; --n, ++cur) {
             mystl::construct(&*cur, value);
         }
+        return cur;
     } catch (const std::exception &e) {
         mystl::destroy(first, cur);
         std::cerr << e.what() << '\n';
@@ -90,11 +137,148 @@ void uninitialized_fill_n(ForwardIterator first, size_t n, const T &value,
 }
 
 template <typename ForwardIterator, typename T>
-void uninitialized_fill_n(ForwardIterator first, size_t n, const T &value) {
+ForwardIterator uninitialized_fill_n(ForwardIterator first, size_t n,
+                                     const T &value) {
     using value_type =
         typename std::iterator_traits<ForwardIterator>::value_type;
-    mystl::uninitialized_fill_n(
+    return mystl::uninitialized_fill_n(
         first, n, value,
         typename mystl::type_traits<value_type>::is_POD_type());
 }
+// uninitialized_default_n
+// 对[first, first + n)做默认初始化(T t;而非T t{})，平凡类型不写内存
+template <typename ForwardIterator>
+ForwardIterator uninitialized_default_n(ForwardIterator first, size_t n,
+                                        mystl::true_type) {
+    mystl::advance(first, n);
+    return first;
+}
+
+template <typename ForwardIterator>
+ForwardIterator uninitialized_default_n(ForwardIterator first, size_t n,
+                                        mystl::false_type) {
+    using value_type =
+        typename std::iterator_traits<ForwardIterator>::value_type;
+    ForwardIterator cur = first;
+    try {
+        for (; n > 0; --n, ++cur) {
+            ::new (static_cast<void *>(&*cur)) value_type;
+        }
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(first, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename ForwardIterator>
+ForwardIterator uninitialized_default_n(ForwardIterator first, size_t n) {
+    using value_type =
+        typename std::iterator_traits<ForwardIterator>::value_type;
+    return mystl::uninitialized_default_n(
+        first, n,
+        mystl::integral_constant<
+            bool, std::is_trivially_default_constructible<value_type>::value>());
+}
+
+/**************************************************************************** */
+// deque_iterator的分段版本
+// 按缓冲区逐段调用指针版本，某一段抛出异常时销毁之前各段已构造的元素
+/**************************************************************************** */
+// 连续内存 -> deque
+template <typename T1, typename T2, size_t BufSize>
+deque_iterator<T2, BufSize> uninitialized_copy(
+    T1 *first, T1 *last, deque_iterator<T2, BufSize> result) {
+    deque_iterator<T2, BufSize> cur = result;
+    try {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            const ptrdiff_t room = cur.last - cur.cur;
+            const ptrdiff_t len = n < room ? n : room;
+            mystl::uninitialized_copy(first, first + len, cur.cur);
+            first += len;
+            n -= len;
+            cur += len;
+        }
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(result, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+// deque -> 任意输出
+template <typename T, size_t BufSize, typename ForwardIterator>
+ForwardIterator uninitialized_copy(deque_iterator<T, BufSize> first,
+                                   deque_iterator<T, BufSize> last,
+                                   ForwardIterator result) {
+    ForwardIterator cur = result;
+    try {
+        mystl::for_each_segment(first, last, [&](T *b, T *e) {
+            cur = mystl::uninitialized_copy(b, e, cur);
+        });
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(result, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename T1, typename T2, size_t BufSize>
+deque_iterator<T2, BufSize> uninitialized_move(
+    T1 *first, T1 *last, deque_iterator<T2, BufSize> result) {
+    deque_iterator<T2, BufSize> cur = result;
+    try {
+        ptrdiff_t n = last - first;
+        while (n > 0) {
+            const ptrdiff_t room = cur.last - cur.cur;
+            const ptrdiff_t len = n < room ? n : room;
+            mystl::uninitialized_move(first, first + len, cur.cur);
+            first += len;
+            n -= len;
+            cur += len;
+        }
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(result, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename T, size_t BufSize, typename ForwardIterator>
+ForwardIterator uninitialized_move(deque_iterator<T, BufSize> first,
+                                   deque_iterator<T, BufSize> last,
+                                   ForwardIterator result) {
+    ForwardIterator cur = result;
+    try {
+        mystl::for_each_segment(first, last, [&](T *b, T *e) {
+            cur = mystl::uninitialized_move(b, e, cur);
+        });
+        return cur;
+    } catch (const std::exception &e) {
+        mystl::destroy(result, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
+template <typename T, size_t BufSize, typename U>
+void uninitialized_fill(deque_iterator<T, BufSize> first,
+                        deque_iterator<T, BufSize> last, const U &value) {
+    deque_iterator<T, BufSize> cur = first;
+    try {
+        mystl::for_each_segment(first, last, [&](T *b, T *e) {
+            mystl::uninitialized_fill(b, e, value);
+            cur += e - b;
+        });
+    } catch (const std::exception &e) {
+        mystl::destroy(first, cur);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
 }  // namespace mystl
\ No newline at end of file
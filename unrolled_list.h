@@ -0,0 +1,895 @@
+#pragma once
+
+// 展开链表：双向链表的每个节点存放最多N个连续元素
+// 顺序遍历大部分时间在连续内存上进行，接近vector；中间插入删除只移动
+// 一个节点内的元素。节点满时对半分裂，元素过少时与相邻节点合并。
+// 插入删除只会使所在节点(以及被合并的相邻节点)中元素的迭代器失效，
+// 其他节点中元素的迭代器保持有效。
+// 接口与list一致；for_each_segment按节点把连续区间交给回调，
+// for_each/find/copy据此逐段处理。
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#include "alloc.h"
+#include "algobase.h"
+#include "construct.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "list.h"
+#include "uninitialized.h"
+#include "util.h"
+
+namespace mystl {
+// 默认每个节点约2KB的元素，至少8个
+// 节点越小，遍历时跨节点的指针跳转越频繁；2KB时顺序遍历已接近vector，
+// 节点内移动元素的开销仍然很小
+constexpr size_t unrolled_list_node_capacity(size_t size) {
+    return 2048 / size >= 8 ? 2048 / size : 8;
+}
+
+struct unrolled_list_node_base {
+    unrolled_list_node_base *prev;
+    unrolled_list_node_base *next;
+    size_t count;  // 链表头为0
+};
+
+template <typename T, size_t N>
+struct unrolled_list_node : unrolled_list_node_base {
+    alignas(T) unsigned char raw[sizeof(T) * N];
+
+    T *data() { return std::launder(reinterpret_cast<T *>(raw)); }
+};
+
+template <typename T, size_t N, bool Const>
+class unrolled_list_iterator {
+   public:
+    using iterator_category = bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::conditional<Const, const T *, T *>::type;
+    using reference = typename std::conditional<Const, const T &, T &>::type;
+
+    using node_type = unrolled_list_node<T, N>;
+
+    // end()为{链表头, 0}，其余位置index < node->count
+    unrolled_list_node_base *node;
+    size_t index;
+
+    unrolled_list_iterator() : node(nullptr), index(0) {}
+    unrolled_list_iterator(unrolled_list_node_base *x, size_t i)
+        : node(x), index(i) {}
+    template <bool C, typename = typename std::enable_if<Const && !C>::type>
+    unrolled_list_iterator(const unrolled_list_iterator<T, N, C> &rhs)
+        : node(rhs.node), index(rhs.index) {}
+
+    pointer data() const { return static_cast<node_type *>(node)->data(); }
+
+    reference operator*() const { return data()[index]; }
+    pointer operator->() const { return data() + index; }
+
+    unrolled_list_iterator &operator++() {
+        if (++index == node->count) {
+            node = node->next;
+            index = 0;
+        }
+        return *this;
+    }
+    unrolled_list_iterator operator++(int) {
+        unrolled_list_iterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    unrolled_list_iterator &operator--() {
+        if (index == 0) {
+            node = node->prev;
+            index = node->count;
+        }
+        --index;
+        return *this;
+    }
+    unrolled_list_iterator operator--(int) {
+        unrolled_list_iterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+    // 与list_iterator相同，逐个移动，供reverse_iterator使用
+    unrolled_list_iterator operator+(difference_type n) const {
+        unrolled_list_iterator tmp = *this;
+        for (; n > 0; --n) ++tmp;
+        for (; n < 0; ++n) --tmp;
+        return tmp;
+    }
+    unrolled_list_iterator operator-(difference_type n) const {
+        return *this + (-n);
+    }
+
+    bool operator==(const unrolled_list_iterator &rhs) const {
+        return node == rhs.node && index == rhs.index;
+    }
+    bool operator!=(const unrolled_list_iterator &rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+template <typename T, size_t N = unrolled_list_node_capacity(sizeof(T)),
+          typename Alloc = mystl::simple_alloc<unrolled_list_node<T, N>>>
+class unrolled_list {
+    static_assert(N >= 2, "unrolled_list node capacity must be at least 2");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = unrolled_list_iterator<T, N, false>;
+    using const_iterator = unrolled_list_iterator<T, N, true>;
+    using reverse_iterator = mystl::reverse_iterator<iterator>;
+    using const_reverse_iterator = mystl::reverse_iterator<const_iterator>;
+
+    static constexpr size_type node_capacity = N;
+
+   protected:
+    using base_ptr = unrolled_list_node_base *;
+    using node_type = unrolled_list_node<T, N>;
+    using node_ptr = node_type *;
+
+    // 相邻两个节点合计不超过这么多个元素时合并，
+    // 留出余量，避免刚分裂的两半删掉一个元素就又合并
+    static constexpr size_type merge_limit = N - N / 4;
+
+    unrolled_list_node_base header;
+    size_type total;
+
+    static T *data(base_ptr p) { return static_cast<node_ptr>(p)->data(); }
+
+    void init() {
+        header.prev = header.next = &header;
+        header.count = 0;
+        total = 0;
+    }
+
+    // 在pos之前接入一个空节点
+    base_ptr create_node(base_ptr pos) {
+        node_ptr p = Alloc::allocate();
+        p->count = 0;
+        p->prev = pos->prev;
+        p->next = pos;
+        pos->prev->next = p;
+        pos->prev = p;
+        return p;
+    }
+    // 摘下并释放节点，元素需已析构
+    void destroy_node(base_ptr p) {
+        p->prev->next = p->next;
+        p->next->prev = p->prev;
+        Alloc::deallocate(static_cast<node_ptr>(p));
+    }
+
+    // 把满节点的后一半移到新的后继节点
+    void split(base_ptr p);
+    // 把a的后继并入a，(n, i)是需要跟踪的位置
+    bool try_merge(base_ptr a, base_ptr &n, size_type &i);
+    // 在节点p的位置i放入value，p需有空位
+    void insert_in_node(base_ptr p, size_type i, value_type &&value);
+    // 析构节点p中的[i, j)，后面的元素前移
+    void erase_in_node(base_ptr p, size_type i, size_type j);
+
+    void fill_init(size_type n, const value_type &value);
+    template <typename InputIterator>
+    void range_init(InputIterator first, InputIterator last);
+
+   public:
+    // 构造函数
+    unrolled_list() { init(); }
+    explicit unrolled_list(size_type n) { fill_init(n, value_type()); }
+    unrolled_list(size_type n, const value_type &value) {
+        fill_init(n, value);
+    }
+    template <typename InputIterator,
+              typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                      int>::type = 0>
+    unrolled_list(InputIterator first, InputIterator last) {
+        range_init(first, last);
+    }
+    unrolled_list(std::initializer_list<value_type> il) {
+        range_init(il.begin(), il.end());
+    }
+    unrolled_list(const unrolled_list &rhs) {
+        range_init(rhs.begin(), rhs.end());
+    }
+    unrolled_list(unrolled_list &&rhs) noexcept {
+        init();
+        swap(rhs);
+    }
+
+    unrolled_list &operator=(const unrolled_list &rhs) {
+        if (this != &rhs) {
+            unrolled_list tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+    unrolled_list &operator=(unrolled_list &&rhs) noexcept {
+        if (this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+    unrolled_list &operator=(std::initializer_list<value_type> il) {
+        unrolled_list tmp(il);
+        swap(tmp);
+        return *this;
+    }
+
+    // 析构函数
+    ~unrolled_list() { clear(); }
+
+    // 迭代器
+    iterator begin() { return iterator(header.next, 0); }
+    const_iterator begin() const {
+        return const_iterator(header.next, 0);
+    }
+    iterator end() { return iterator(&header, 0); }
+    const_iterator end() const {
+        return const_iterator(const_cast<base_ptr>(&header), 0);
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    // 容量
+    bool empty() const { return total == 0; }
+    size_type size() const { return total; }
+    size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    // 访问
+    reference front() {
+        MYSTL_DEBUG(!empty());
+        return data(header.next)[0];
+    }
+    const_reference front() const {
+        MYSTL_DEBUG(!empty());
+        return data(header.next)[0];
+    }
+    reference back() {
+        MYSTL_DEBUG(!empty());
+        return data(header.prev)[header.prev->count - 1];
+    }
+    const_reference back() const {
+        MYSTL_DEBUG(!empty());
+        return data(header.prev)[header.prev->count - 1];
+    }
+
+    // 插入，返回指向新元素的迭代器
+    template <typename... Args>
+    iterator emplace(const_iterator position, Args &&...args);
+    iterator insert(const_iterator position, const value_type &value) {
+        return emplace(position, value);
+    }
+    iterator insert(const_iterator position, value_type &&value) {
+        return emplace(position, mystl::move(value));
+    }
+    iterator insert(const_iterator position, size_type n,
+                    const value_type &value);
+    template <typename InputIterator,
+              typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                      int>::type = 0>
+    iterator insert(const_iterator position, InputIterator first,
+                    InputIterator last);
+
+    template <typename... Args>
+    reference emplace_front(Args &&...args) {
+        return *emplace(begin(), mystl::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    reference emplace_back(Args &&...args) {
+        return *emplace(end(), mystl::forward<Args>(args)...);
+    }
+    void push_front(const value_type &value) { emplace_front(value); }
+    void push_front(value_type &&value) { emplace_front(mystl::move(value)); }
+    void push_back(const value_type &value) { emplace_back(value); }
+    void push_back(value_type &&value) { emplace_back(mystl::move(value)); }
+
+    // 删除，返回被删元素之后的位置
+    iterator erase(const_iterator position) {
+        const_iterator next = position;
+        return erase(position, ++next);
+    }
+    iterator erase(const_iterator first, const_iterator last);
+    void pop_front() {
+        MYSTL_DEBUG(!empty());
+        erase(begin());
+    }
+    void pop_back() {
+        MYSTL_DEBUG(!empty());
+        erase(const_iterator(header.prev, header.prev->count - 1));
+    }
+    void clear();
+
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+    void resize(size_type new_size, const value_type &value);
+
+    void swap(unrolled_list &rhs) noexcept;
+
+    // 链表操作
+    template <typename Predicate>
+    void remove_if(Predicate pred);
+    void remove(const value_type &value) {
+        remove_if([&](const value_type &x) { return x == value; });
+    }
+    void unique();
+    void reverse();
+    // 稳定排序，重新装填为满节点
+    void sort();
+    // 两个链表都已有序，结果重新装填为满节点
+    void merge(unrolled_list &other);
+    // 整表splice只在position处分裂一次节点，其余节点直接接入
+    void splice(const_iterator position, unrolled_list &other);
+    // 区间splice需要移动元素，代价与区间长度成正比
+    void splice(const_iterator position, unrolled_list &other,
+                const_iterator i);
+    void splice(const_iterator position, unrolled_list &other,
+                const_iterator first, const_iterator last);
+};
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::split(base_ptr p) {
+    const size_type half = p->count / 2;
+    base_ptr q = create_node(p->next);
+    T *src = data(p);
+    mystl::uninitialized_move(src + half, src + p->count, data(q));
+    mystl::destroy(src + half, src + p->count);
+    q->count = p->count - half;
+    p->count = half;
+}
+
+template <typename T, size_t N, typename Alloc>
+bool unrolled_list<T, N, Alloc>::try_merge(base_ptr a, base_ptr &n,
+                                           size_type &i) {
+    base_ptr b = a->next;
+    if (a == &header || b == &header) return false;
+    if (a->count + b->count > merge_limit) return false;
+    mystl::uninitialized_move(data(b), data(b) + b->count,
+                              data(a) + a->count);
+    mystl::destroy(data(b), data(b) + b->count);
+    if (n == b) {
+        n = a;
+        i += a->count;
+    }
+    a->count += b->count;
+    destroy_node(b);
+    return true;
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::insert_in_node(base_ptr p, size_type i,
+                                                value_type &&value) {
+    T *d = data(p);
+    const size_type n = p->count;
+    if (i == n) {
+        mystl::construct(d + n, mystl::move(value));
+    } else {
+        mystl::construct(d + n, mystl::move(d[n - 1]));
+        mystl::move_backward(d + i, d + n - 1, d + n);
+        d[i] = mystl::move(value);
+    }
+    ++p->count;
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::erase_in_node(base_ptr p, size_type i,
+                                               size_type j) {
+    if (i == j) return;
+    T *d = data(p);
+    mystl::move(d + j, d + p->count, d + i);
+    mystl::destroy(d + p->count - (j - i), d + p->count);
+    p->count -= j - i;
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::fill_init(size_type n,
+                                           const value_type &value) {
+    init();
+    try {
+        for (; n > 0; --n) {
+            emplace_back(value);
+        }
+    } catch (const std::exception &e) {
+        clear();
+        throw;
+    }
+}
+
+template <typename T, size_t N, typename Alloc>
+template <typename InputIterator>
+void unrolled_list<T, N, Alloc>::range_init(InputIterator first,
+                                            InputIterator last) {
+    init();
+    try {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } catch (const std::exception &e) {
+        clear();
+        throw;
+    }
+}
+
+// 先在节点外构造新元素，再调整节点
+// 头部插入优先放到前一个节点的尾部，尾部插入优先放到最后一个节点，
+// 这样push_front/push_back得到的都是满节点
+template <typename T, size_t N, typename Alloc>
+template <typename... Args>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::emplace(const_iterator position, Args &&...args) {
+    value_type value(mystl::forward<Args>(args)...);
+    base_ptr n = position.node;
+    size_type i = position.index;
+    if (i == 0 && n->prev != &header && n->prev->count < N) {
+        n = n->prev;
+        i = n->count;
+    } else if (n == &header || (i == 0 && n->count == N)) {
+        n = create_node(n);
+        i = 0;
+    } else if (n->count == N) {
+        split(n);
+        if (i > n->count) {
+            i -= n->count;
+            n = n->next;
+        }
+    }
+    insert_in_node(n, i, mystl::move(value));
+    ++total;
+    return iterator(n, i);
+}
+
+template <typename T, size_t N, typename Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::insert(const_iterator position, size_type n,
+                                   const value_type &value) {
+    if (n == 0) return iterator(position.node, position.index);
+    iterator result = emplace(position, value);
+    iterator cur = result;
+    while (--n > 0) {
+        cur = emplace(++cur, value);
+    }
+    return result;
+}
+
+// 逐个插在上一个新元素之后，position之后的元素只在各自节点内移动
+template <typename T, size_t N, typename Alloc>
+template <typename InputIterator,
+          typename std::enable_if<!std::is_integral<InputIterator>::value,
+                                  int>::type>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::insert(const_iterator position,
+                                   InputIterator first, InputIterator last) {
+    if (first == last) return iterator(position.node, position.index);
+    iterator result = emplace(position, *first);
+    iterator cur = result;
+    for (++first; first != last; ++first) {
+        cur = emplace(++cur, *first);
+    }
+    return result;
+}
+
+template <typename T, size_t N, typename Alloc>
+typename unrolled_list<T, N, Alloc>::iterator
+unrolled_list<T, N, Alloc>::erase(const_iterator first, const_iterator last) {
+    if (first == last) return iterator(last.node, last.index);
+    base_ptr fn = first.node;
+    base_ptr ln = last.node;
+    // (n, i)跟踪原来last处的元素
+    base_ptr n;
+    size_type i;
+    if (fn == ln) {
+        total -= last.index - first.index;
+        erase_in_node(fn, first.index, last.index);
+        n = fn;
+        i = first.index;
+    } else {
+        total -= fn->count - first.index;
+        erase_in_node(fn, first.index, fn->count);
+        for (base_ptr p = fn->next; p != ln;) {
+            base_ptr next = p->next;
+            total -= p->count;
+            mystl::destroy(data(p), data(p) + p->count);
+            destroy_node(p);
+            p = next;
+        }
+        if (ln != &header) {
+            total -= last.index;
+            erase_in_node(ln, 0, last.index);
+        }
+        n = ln;
+        i = 0;
+    }
+    if (n != &header && i == n->count) {
+        n = n->next;
+        i = 0;
+    }
+    if (fn->count == 0) {
+        base_ptr prev = fn->prev;
+        destroy_node(fn);
+        try_merge(prev, n, i);
+    } else {
+        // fn可能并入前一个节点后被释放
+        base_ptr prev = fn->prev;
+        if (try_merge(prev, n, i)) fn = prev;
+        try_merge(fn, n, i);
+    }
+    return iterator(n, i);
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::clear() {
+    base_ptr p = header.next;
+    while (p != &header) {
+        base_ptr next = p->next;
+        mystl::destroy(data(p), data(p) + p->count);
+        Alloc::deallocate(static_cast<node_ptr>(p));
+        p = next;
+    }
+    init();
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::resize(size_type new_size,
+                                        const value_type &value) {
+    if (new_size < total) {
+        iterator first = begin();
+        for (size_type k = 0; k < new_size;) {
+            // 整个节点一起跳过
+            const size_type rest = first.node->count - first.index;
+            if (new_size - k >= rest) {
+                k += rest;
+                first = iterator(first.node->next, 0);
+            } else {
+                first.index += new_size - k;
+                k = new_size;
+            }
+        }
+        erase(first, end());
+    } else {
+        for (size_type k = total; k < new_size; ++k) {
+            emplace_back(value);
+        }
+    }
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::swap(unrolled_list &rhs) noexcept {
+    if (this == &rhs) return;
+    base_ptr first = header.next, last = header.prev;
+    base_ptr rfirst = rhs.header.next, rlast = rhs.header.prev;
+    const bool was_empty = empty(), rhs_empty = rhs.empty();
+    if (rhs_empty) {
+        header.prev = header.next = &header;
+    } else {
+        header.next = rfirst;
+        header.prev = rlast;
+        rfirst->prev = rlast->next = &header;
+    }
+    if (was_empty) {
+        rhs.header.prev = rhs.header.next = &rhs.header;
+    } else {
+        rhs.header.next = first;
+        rhs.header.prev = last;
+        first->prev = last->next = &rhs.header;
+    }
+    mystl::swap(total, rhs.total);
+}
+
+// 逐个节点在节点内把保留的元素前移，元素不会跨节点移动：
+// 只有删除了元素的节点中元素的迭代器失效，其他节点不受影响。
+// 删空的节点直接释放，不与相邻节点合并，留下的小节点在之后的插入删除中合并。
+// pred抛出异常时已经判定删除的元素被删除，其余元素保留
+template <typename T, size_t N, typename Alloc>
+template <typename Predicate>
+void unrolled_list<T, N, Alloc>::remove_if(Predicate pred) {
+    for (base_ptr p = header.next; p != &header;) {
+        base_ptr next = p->next;
+        T *d = data(p);
+        size_type w = 0, r = 0;
+        try {
+            for (; r < p->count; ++r) {
+                if (!pred(d[r])) {
+                    if (w != r) d[w] = mystl::move(d[r]);
+                    ++w;
+                }
+            }
+        } catch (const std::exception &e) {
+            total -= r - w;
+            erase_in_node(p, w, r);
+            throw;
+        }
+        total -= p->count - w;
+        erase_in_node(p, w, p->count);
+        if (p->count == 0) destroy_node(p);
+        p = next;
+    }
+}
+
+// 与remove_if一样逐个节点处理，last指向上一个保留的元素，可能在前面的节点中
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::unique() {
+    if (total <= 1) return;
+    T *last = nullptr;
+    for (base_ptr p = header.next; p != &header;) {
+        base_ptr next = p->next;
+        T *d = data(p);
+        size_type w = 0, r = 0;
+        try {
+            for (; r < p->count; ++r) {
+                if (last == nullptr || !(d[r] == *last)) {
+                    if (w != r) d[w] = mystl::move(d[r]);
+                    last = d + w;
+                    ++w;
+                }
+            }
+        } catch (const std::exception &e) {
+            total -= r - w;
+            erase_in_node(p, w, r);
+            throw;
+        }
+        total -= p->count - w;
+        erase_in_node(p, w, p->count);
+        if (p->count == 0) destroy_node(p);
+        p = next;
+    }
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::reverse() {
+    base_ptr p = &header;
+    do {
+        base_ptr next = p->next;
+        p->next = p->prev;
+        p->prev = next;
+        if (p != &header) {
+            T *d = data(p);
+            for (size_type l = 0, r = p->count - 1; l < r; ++l, --r) {
+                mystl::swap(d[l], d[r]);
+            }
+        }
+        p = next;
+    } while (p != &header);
+}
+
+// 元素指针用list::sort的数组归并排好序，再按顺序移动到新节点
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::sort() {
+    if (total <= 1) return;
+    using ptr_alloc = typename Alloc::template rebind<T *>::other;
+    using bound_alloc = typename Alloc::template rebind<size_t>::other;
+
+    const size_type n = total;
+    const size_type bn = detail::list_sort_bounds_size(n);
+    T **a = ptr_alloc::allocate(n);
+    T **b = ptr_alloc::allocate(n);
+    size_t *bounds = bound_alloc::allocate(bn);
+    size_type k = 0;
+    for (base_ptr p = header.next; p != &header; p = p->next) {
+        for (size_type j = 0; j < p->count; ++j) {
+            a[k++] = data(p) + j;
+        }
+    }
+    unrolled_list sorted;
+    try {
+        T **result = detail::list_sort_array(
+            a, b, n, bounds, [](const T *x, const T *y) { return *x < *y; });
+        for (k = 0; k < n; ++k) {
+            sorted.emplace_back(mystl::move(*result[k]));
+        }
+    } catch (const std::exception &e) {
+        ptr_alloc::deallocate(a, n);
+        ptr_alloc::deallocate(b, n);
+        bound_alloc::deallocate(bounds, bn);
+        throw;
+    }
+    ptr_alloc::deallocate(a, n);
+    ptr_alloc::deallocate(b, n);
+    bound_alloc::deallocate(bounds, bn);
+    swap(sorted);
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::merge(unrolled_list &other) {
+    if (this == &other || other.empty()) return;
+    unrolled_list merged;
+    iterator first1 = begin(), first2 = other.begin();
+    while (first1 != end() && first2 != other.end()) {
+        if (*first2 < *first1) {
+            merged.emplace_back(mystl::move(*first2++));
+        } else {
+            merged.emplace_back(mystl::move(*first1++));
+        }
+    }
+    for (; first1 != end(); ++first1) {
+        merged.emplace_back(mystl::move(*first1));
+    }
+    for (; first2 != other.end(); ++first2) {
+        merged.emplace_back(mystl::move(*first2));
+    }
+    other.clear();
+    swap(merged);
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::splice(const_iterator position,
+                                        unrolled_list &other) {
+    if (this == &other || other.empty()) return;
+    base_ptr pos = position.node;
+    if (position.index != 0) {
+        // 把position所在节点从position处断开
+        base_ptr q = create_node(pos->next);
+        T *src = data(pos);
+        mystl::uninitialized_move(src + position.index, src + pos->count,
+                                  data(q));
+        mystl::destroy(src + position.index, src + pos->count);
+        q->count = pos->count - position.index;
+        pos->count = position.index;
+        pos = q;
+    }
+    base_ptr first = other.header.next, last = other.header.prev;
+    first->prev = pos->prev;
+    last->next = pos;
+    pos->prev->next = first;
+    pos->prev = last;
+    total += other.total;
+    other.init();
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::splice(const_iterator position,
+                                        unrolled_list &other,
+                                        const_iterator i) {
+    const_iterator next = i;
+    splice(position, other, i, ++next);
+}
+
+template <typename T, size_t N, typename Alloc>
+void unrolled_list<T, N, Alloc>::splice(const_iterator position,
+                                        unrolled_list &other,
+                                        const_iterator first,
+                                        const_iterator last) {
+    if (first == last || position == first) return;
+    if (this == &other) {
+        // 同一链表内先移出到临时链表，position不能在[first, last)内
+        unrolled_list tmp;
+        for (const_iterator it = first; it != last; ++it) {
+            tmp.emplace_back(mystl::move(*iterator(it.node, it.index)));
+        }
+        // 删除会移动position所在节点中的元素，先记下它前面保留下来的
+        // 元素个数，删除后再重新定位
+        size_type offset = 0;
+        for (const_iterator it = begin(); it != position;) {
+            if (it == first) {
+                it = last;
+            } else {
+                ++offset;
+                ++it;
+            }
+        }
+        erase(first, last);
+        iterator pos = begin();
+        for (; offset > 0; --offset) ++pos;
+        splice(pos, tmp);
+        return;
+    }
+    iterator pos(position.node, position.index);
+    for (const_iterator it = first; it != last; ++it) {
+        pos = emplace(pos, mystl::move(*iterator(it.node, it.index)));
+        ++pos;
+    }
+    other.erase(first, last);
+}
+
+// 逐节点把连续区间[段首, 段尾)交给f
+template <typename T, size_t N, bool C, typename Function>
+void for_each_segment(unrolled_list_iterator<T, N, C> first,
+                      unrolled_list_iterator<T, N, C> last, Function f) {
+    if (first == last) return;
+    if (first.node == last.node) {
+        f(first.data() + first.index, first.data() + last.index);
+        return;
+    }
+    f(first.data() + first.index, first.data() + first.node->count);
+    for (auto p = first.node->next; p != last.node; p = p->next) {
+        unrolled_list_iterator<T, N, C> it(p, 0);
+        f(it.data(), it.data() + p->count);
+    }
+    if (last.index != 0) {
+        f(last.data(), last.data() + last.index);
+    }
+}
+
+template <typename T, size_t N, bool C, typename Function>
+Function for_each(unrolled_list_iterator<T, N, C> first,
+                  unrolled_list_iterator<T, N, C> last, Function f) {
+    mystl::for_each_segment(first, last, [&](auto *b, auto *e) {
+        for (; b != e; ++b) f(*b);
+    });
+    return f;
+}
+
+template <typename T, size_t N, bool C, typename OutputIterator>
+OutputIterator copy(unrolled_list_iterator<T, N, C> first,
+                    unrolled_list_iterator<T, N, C> last,
+                    OutputIterator result) {
+    mystl::for_each_segment(first, last, [&](auto *b, auto *e) {
+        result = mystl::copy(b, e, result);
+    });
+    return result;
+}
+
+// 每个节点内用指针版本的find
+template <typename T, size_t N, bool C, typename U>
+unrolled_list_iterator<T, N, C> find(unrolled_list_iterator<T, N, C> first,
+                                     unrolled_list_iterator<T, N, C> last,
+                                     const U &value) {
+    while (first != last) {
+        const size_t end =
+            first.node == last.node ? last.index : first.node->count;
+        auto b = first.data();
+        auto p = mystl::find(b + first.index, b + end, value);
+        if (p != b + end) {
+            return unrolled_list_iterator<T, N, C>(first.node, p - b);
+        }
+        if (first.node == last.node) break;
+        first = unrolled_list_iterator<T, N, C>(first.node->next, 0);
+    }
+    return last;
+}
+
+// 比较操作
+template <typename T, size_t N, typename Alloc>
+bool operator==(const unrolled_list<T, N, Alloc> &lhs,
+                const unrolled_list<T, N, Alloc> &rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    auto first1 = lhs.begin();
+    auto first2 = rhs.begin();
+    for (; first1 != lhs.end(); ++first1, ++first2) {
+        if (!(*first1 == *first2)) return false;
+    }
+    return true;
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator!=(const unrolled_list<T, N, Alloc> &lhs,
+                const unrolled_list<T, N, Alloc> &rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator<(const unrolled_list<T, N, Alloc> &lhs,
+               const unrolled_list<T, N, Alloc> &rhs) {
+    auto first1 = lhs.begin(), last1 = lhs.end();
+    auto first2 = rhs.begin(), last2 = rhs.end();
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2) {
+        if (*first1 < *first2) return true;
+        if (*first2 < *first1) return false;
+    }
+    return first1 == last1 && first2 != last2;
+}
+
+template <typename T, size_t N, typename Alloc>
+void swap(unrolled_list<T, N, Alloc> &lhs,
+          unrolled_list<T, N, Alloc> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace mystl
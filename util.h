@@ -5,6 +5,9 @@
 #include "type_traits.h"
 
 namespace mystl {
+// 缓存行大小，并发容器用它把不同线程写的字段隔开，避免伪共享
+constexpr size_t cache_line_size = 64;
+
 // move
 template <class T>
 typename std::remove_reference<T>::type &&move(T &&arg) noexcept {
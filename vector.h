@@ -4,6 +4,8 @@
 #include <initializer_list>
 
 #include "alloc.h"
+#include "parallel.h"
+#include "simd.h"
 #include "uninitialized.h"
 
 namespace mystl {
@@ -41,6 +43,7 @@ class vector {
     }
 
     void fill_initialize(size_type n, const value_type &value);
+    void default_initialize(size_type n);
 
     template <typename InputIterator>
     void copy_initialize(InputIterator first, InputIterator last);
@@ -52,6 +55,8 @@ class vector {
     vector(size_type n) { fill_initialize(n, value_type()); }
     vector(int n, const value_type &value) { fill_initialize(n, value); }
     vector(size_type n, const value_type &value) { fill_initialize(n, value); }
+    // 平凡类型的元素不做初始化，适合随后整体覆盖写入的缓冲区
+    vector(size_type n, default_init_t) { default_initialize(n); }
 
     vector(const vector<T> &v) { copy_initialize(v.begin(), v.end()); }
 
@@ -67,7 +72,8 @@ class vector {
             size_type new_size = v.size();
             if (new_size > cap()) {
                 iterator new_start = Alloc::allocate(new_size);
-                capacity = uninitialized_copy(v.begin(), v.end(), new_start);
+                capacity =
+                    parallel_uninitialized_copy(v.begin(), v.end(), new_start);
                 destroy(start, finish);
                 deallocate();
                 start = new_start;
@@ -76,7 +82,8 @@ class vector {
                 destroy(iter, finish);
             } else {
                 std::copy(v.begin(), v.begin() + size(), start);
-                uninitialized_copy(v.begin() + size(), v.end(), finish);
+                parallel_uninitialized_copy(v.begin() + size(), v.end(),
+                                            finish);
             }
             finish = start + new_size;
         }
@@ -136,6 +143,7 @@ class vector {
     iterator erase(iterator first, iterator last);
     void resize(size_type new_size, const T &value);
     void resize(size_type new_size);
+    void resize_default_init(size_type new_size);
     void clear();
 };
 
@@ -175,7 +183,7 @@ inline void vector<T, Alloc>::fill_initialize(size_type n,
                                               const value_type &value) {
     start = allocator_type::allocate(n);
     try {
-        uninitialized_fill(start, start + n, value);
+        parallel_uninitialized_fill_n(start, n, value);
         finish = start + n;
         capacity = start + n;
     } catch (const std::exception &e) {
@@ -185,13 +193,26 @@ inline void vector<T, Alloc>::fill_initialize(size_type n,
     }
 }
 
+template <typename T, typename Alloc>
+inline void vector<T, Alloc>::default_initialize(size_type n) {
+    start = allocator_type::allocate(n);
+    try {
+        finish = uninitialized_default_n(start, n);
+        capacity = start + n;
+    } catch (const std::exception &e) {
+        allocator_type::deallocate(start, n);
+        std::cerr << e.what() << '\n';
+        throw;
+    }
+}
+
 template <typename T, typename Alloc>
 template <typename InputIterator>
 inline void vector<T, Alloc>::copy_initialize(InputIterator first,
                                               InputIterator last) {
     start = allocator_type::allocate(last - first);
     try {
-        finish = uninitialized_copy(first, last, start);
+        finish = parallel_uninitialized_copy(first, last, start);
         capacity = finish;
     } catch (const std::exception &e) {
         allocator_type::deallocate(start, size());
@@ -248,8 +269,7 @@ void vector<T, Alloc>::insert(iterator position, size_type n, const T &value) {
             try {
                 new_finish = uninitialized_copy(start, position, new_start);
                 new_finish = uninitialized_fill_n(new_finish, n, value);
-                new_finish =
-                    uninitialized_copy(position, finish, new_finish + n);
+                new_finish = uninitialized_copy(position, finish, new_finish);
                 destroy(start, finish);
                 deallocate();
                 start = new_start;
@@ -302,31 +322,53 @@ void vector<T, Alloc>::resize(size_type new_size) {
     resize(new_size, T());
 }
 
+// 与resize相同，但新增的平凡类型元素保持未初始化
+template <typename T, typename Alloc>
+void vector<T, Alloc>::resize_default_init(size_type new_size) {
+    const size_type old_size = size();
+    if (new_size <= old_size) {
+        erase(start + new_size, finish);
+    } else if (new_size <= cap()) {
+        finish = uninitialized_default_n(finish, new_size - old_size);
+    } else {
+        const size_type new_cap =
+            old_size + std::max(old_size, new_size - old_size);
+        iterator new_start = allocator_type::allocate(new_cap);
+        iterator new_finish = new_start;
+        try {
+            new_finish = uninitialized_copy(start, finish, new_start);
+            new_finish =
+                uninitialized_default_n(new_finish, new_size - old_size);
+        } catch (const std::exception &e) {
+            destroy(new_start, new_finish);
+            allocator_type::deallocate(new_start, new_cap);
+            std::cerr << e.what() << '\n';
+            throw;
+        }
+        destroy(start, finish);
+        deallocate();
+        start = new_start;
+        finish = new_finish;
+        capacity = new_start + new_cap;
+    }
+}
+
 template <typename T, typename Alloc>
 void vector<T, Alloc>::clear() {
     erase(start, finish);
 }
 
+// 元素连续存放，比较直接交给simd内核；operator<对无符号单字节类型用memcmp，
+// 其他算术类型用向量化的mismatch跳过相等前缀，其余类型只用元素的operator<
 template <typename T, typename Alloc>
 bool operator==(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
     return lhs.size() == rhs.size() &&
-           std::equal(lhs.begin(), lhs.end(), rhs.begin());
+           simd::equal(lhs.begin(), rhs.begin(), lhs.size());
 }
 
 template <typename T, typename Alloc>
 bool operator<(const vector<T, Alloc> &lhs, const vector<T, Alloc> &rhs) {
-    auto lhs_first = lhs.begin();
-    auto lhs_last = lhs.end();
-    auto rhs_first = rhs.begin();
-    auto rhs_last = rhs.end();
-    for (; lhs_first != lhs_last && rhs_first != rhs_last;
-         ++lhs_first, ++rhs_first) {
-        if (*lhs_first < *rhs_first) {
-            return true;
-        } else if (*rhs_first < *lhs_first) {
-            return false;
-        }
-    }
-    return lhs_first == lhs_last && rhs_first != rhs_last;
+    return simd::lexicographical_compare(lhs.begin(), lhs.size(), rhs.begin(),
+                                         rhs.size());
 }
 }  // namespace mystl
@@ -0,0 +1,377 @@
+#pragma once
+
+// 平凡可拷贝类型vector的二进制存取
+// 文件格式：64字节的文件头 + 元素的原始字节，文件头保证数据区对齐。
+// save用一次writev写出文件头和数据，load直接读入未初始化的缓冲区；
+// mapped_vector把文件只读映射到内存，不做任何拷贝，访问时才按页载入。
+// 文件使用本机字节序，不能跨字节序或跨元素布局使用，文件头会做检查。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "exceptdef.h"
+#include "vector.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include <cstdio>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace mystl {
+struct vector_file_header {
+    static constexpr uint32_t current_version = 1;
+    static constexpr uint32_t endian_tag = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t elem_size;
+    uint32_t elem_align;
+    uint64_t count;
+    char reserved[32];
+
+    template <typename T>
+    static vector_file_header make(uint64_t count) {
+        vector_file_header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, "MYSTLVEC", 8);
+        h.version = current_version;
+        h.endian = endian_tag;
+        h.elem_size = static_cast<uint32_t>(sizeof(T));
+        h.elem_align = static_cast<uint32_t>(alignof(T));
+        h.count = count;
+        return h;
+    }
+
+    // 检查文件头是否能按T解释
+    template <typename T>
+    void check() const {
+        MYSTL_RUNTIME_ERROR_IF(std::memcmp(magic, "MYSTLVEC", 8) != 0,
+                               "vector file: bad magic");
+        MYSTL_RUNTIME_ERROR_IF(version != current_version,
+                               "vector file: unsupported version");
+        MYSTL_RUNTIME_ERROR_IF(endian != endian_tag,
+                               "vector file: byte order mismatch");
+        MYSTL_RUNTIME_ERROR_IF(
+            elem_size != sizeof(T) || elem_align != alignof(T),
+            "vector file: element layout mismatch");
+    }
+};
+
+static_assert(sizeof(vector_file_header) == 64,
+              "vector_file_header must be 64 bytes");
+
+namespace detail {
+#if defined(_WIN32)
+struct vector_file {
+    std::FILE *fp;
+
+    vector_file(const char *path, bool write)
+        : fp(std::fopen(path, write ? "wb" : "rb")) {
+        MYSTL_RUNTIME_ERROR_IF(fp == nullptr, "vector file: cannot open");
+    }
+    ~vector_file() { std::fclose(fp); }
+
+    void write_all(const void *head, size_t head_size, const void *data,
+                   size_t data_size) {
+        MYSTL_RUNTIME_ERROR_IF(
+            std::fwrite(head, 1, head_size, fp) != head_size ||
+                std::fwrite(data, 1, data_size, fp) != data_size ||
+                std::fflush(fp) != 0,
+            "vector file: write failed");
+    }
+    void read_all(void *buf, size_t n) {
+        MYSTL_RUNTIME_ERROR_IF(std::fread(buf, 1, n, fp) != n,
+                               "vector file: truncated");
+    }
+    // 文件总字节数，不改变读写位置
+    uint64_t size() {
+        const __int64 pos = ::_ftelli64(fp);
+        MYSTL_RUNTIME_ERROR_IF(pos < 0 || ::_fseeki64(fp, 0, SEEK_END) != 0,
+                               "vector file: stat failed");
+        const __int64 end = ::_ftelli64(fp);
+        MYSTL_RUNTIME_ERROR_IF(end < 0 || ::_fseeki64(fp, pos, SEEK_SET) != 0,
+                               "vector file: stat failed");
+        return static_cast<uint64_t>(end);
+    }
+};
+#else
+struct vector_file {
+    int fd;
+
+    vector_file(const char *path, bool write)
+        : fd(write ? ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                            0644)
+                   : ::open(path, O_RDONLY | O_CLOEXEC)) {
+        MYSTL_RUNTIME_ERROR_IF(fd < 0, "vector file: cannot open");
+    }
+    ~vector_file() { ::close(fd); }
+
+    // 一次系统调用写出文件头和数据，短写时从断点继续
+    void write_all(const void *head, size_t head_size, const void *data,
+                   size_t data_size) {
+        iovec iov[2];
+        iov[0].iov_base = const_cast<void *>(head);
+        iov[0].iov_len = head_size;
+        iov[1].iov_base = const_cast<void *>(data);
+        iov[1].iov_len = data_size;
+        iovec *cur = iov;
+        int cnt = data_size == 0 ? 1 : 2;
+        while (cnt > 0) {
+            const ssize_t n = ::writev(fd, cur, cnt);
+            if (n < 0 && errno == EINTR) continue;
+            MYSTL_RUNTIME_ERROR_IF(n <= 0, "vector file: write failed");
+            size_t done = static_cast<size_t>(n);
+            while (cnt > 0 && done >= cur->iov_len) {
+                done -= cur->iov_len;
+                ++cur;
+                --cnt;
+            }
+            if (cnt > 0) {
+                cur->iov_base = static_cast<char *>(cur->iov_base) + done;
+                cur->iov_len -= done;
+            }
+        }
+    }
+    void read_all(void *buf, size_t n) {
+        char *p = static_cast<char *>(buf);
+        while (n > 0) {
+            const ssize_t r = ::read(fd, p, n);
+            if (r < 0 && errno == EINTR) continue;
+            MYSTL_RUNTIME_ERROR_IF(r < 0, "vector file: read failed");
+            MYSTL_RUNTIME_ERROR_IF(r == 0, "vector file: truncated");
+            p += r;
+            n -= static_cast<size_t>(r);
+        }
+    }
+    // 文件总字节数
+    uint64_t size() {
+        struct stat st;
+        MYSTL_RUNTIME_ERROR_IF(::fstat(fd, &st) != 0,
+                               "vector file: stat failed");
+        return static_cast<uint64_t>(st.st_size);
+    }
+};
+#endif
+}  // namespace detail
+
+// save_vector
+// 把v的元素按原始字节写入path，已有文件会被覆盖
+template <typename T, typename Alloc>
+void save_vector(const vector<T, Alloc> &v, const char *path) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "save_vector requires a trivially copyable type");
+    const vector_file_header h = vector_file_header::make<T>(v.size());
+    detail::vector_file file(path, true);
+    file.write_all(&h, sizeof(h), v.begin(), v.size() * sizeof(T));
+}
+
+// load_vector
+// 用path中的数据替换v的内容，元素直接读入不经过初始化。
+// 分配前先用文件的实际大小校验元素个数，损坏的文件头不会引发巨量分配；
+// 数据读入临时vector，成功后才与v交换，失败时v保持原样
+template <typename T, typename Alloc>
+void load_vector(vector<T, Alloc> &v, const char *path) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "load_vector requires a trivially copyable type");
+    detail::vector_file file(path, false);
+    vector_file_header h;
+    file.read_all(&h, sizeof(h));
+    h.check<T>();
+    const uint64_t file_size = file.size();
+    MYSTL_RUNTIME_ERROR_IF(
+        file_size < sizeof(h) ||
+            h.count > (file_size - sizeof(h)) / sizeof(T),
+        "vector file: truncated");
+    MYSTL_LENGTH_ERROR_IF(h.count > static_cast<size_t>(-1) / sizeof(T),
+                          "vector file: element count too big");
+    vector<T, Alloc> tmp;
+    tmp.resize_default_init(static_cast<size_t>(h.count));
+    file.read_all(tmp.begin(), tmp.size() * sizeof(T));
+    v.swap(tmp);
+}
+
+// 只读映射文件的视图，元素地址在对象生命周期内不变
+template <typename T>
+class mapped_vector {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_vector requires a trivially copyable type");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using const_reference = const T &;
+    using const_pointer = const T *;
+    using const_iterator = const T *;
+
+   protected:
+    void *base;
+    size_t length;
+    const T *first;
+    size_type count;
+#if defined(_WIN32)
+    HANDLE mapping;
+#endif
+
+    void attach();
+    void unmap();
+
+   public:
+    // 构造函数
+    mapped_vector()
+        : base(nullptr),
+          length(0),
+          first(nullptr),
+          count(0)
+#if defined(_WIN32)
+          ,
+          mapping(nullptr)
+#endif
+    {
+    }
+    explicit mapped_vector(const char *path) : mapped_vector() { open(path); }
+    mapped_vector(mapped_vector &&rhs) : mapped_vector() { swap(rhs); }
+    mapped_vector &operator=(mapped_vector &&rhs) {
+        if (this != &rhs) {
+            unmap();
+            swap(rhs);
+        }
+        return *this;
+    }
+    mapped_vector(const mapped_vector &) = delete;
+    mapped_vector &operator=(const mapped_vector &) = delete;
+
+    // 析构函数
+    ~mapped_vector() { unmap(); }
+
+    // 映射path，原有的映射先被释放
+    void open(const char *path);
+    void close() { unmap(); }
+    bool is_open() const { return base != nullptr; }
+
+    // 迭代器
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return first + count; }
+
+    // 容量
+    size_type size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // 访问
+    const_pointer data() const { return first; }
+    const_reference operator[](size_type n) const { return first[n]; }
+    const_reference at(size_type n) const {
+        MYSTL_OUT_OF_RANGE_IF(n >= count, "mapped_vector<T>::at");
+        return first[n];
+    }
+    const_reference front() const { return first[0]; }
+    const_reference back() const { return first[count - 1]; }
+
+    void swap(mapped_vector &rhs) {
+        std::swap(base, rhs.base);
+        std::swap(length, rhs.length);
+        std::swap(first, rhs.first);
+        std::swap(count, rhs.count);
+#if defined(_WIN32)
+        std::swap(mapping, rhs.mapping);
+#endif
+    }
+};
+
+#if defined(_WIN32)
+template <typename T>
+void mapped_vector<T>::open(const char *path) {
+    unmap();
+    HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    MYSTL_RUNTIME_ERROR_IF(file == INVALID_HANDLE_VALUE,
+                           "vector file: cannot open");
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(file, &file_size) ||
+        static_cast<uint64_t>(file_size.QuadPart) <
+            sizeof(vector_file_header)) {
+        ::CloseHandle(file);
+        MYSTL_RUNTIME_ERROR_IF(true, "vector file: truncated");
+    }
+    HANDLE map =
+        ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(file);
+    MYSTL_RUNTIME_ERROR_IF(map == nullptr, "vector file: mmap failed");
+    void *p = ::MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+    if (p == nullptr) {
+        ::CloseHandle(map);
+        MYSTL_RUNTIME_ERROR_IF(true, "vector file: mmap failed");
+    }
+    base = p;
+    length = static_cast<size_t>(file_size.QuadPart);
+    mapping = map;
+    attach();
+}
+#else
+template <typename T>
+void mapped_vector<T>::open(const char *path) {
+    unmap();
+    detail::vector_file file(path, false);
+    struct stat st;
+    MYSTL_RUNTIME_ERROR_IF(::fstat(file.fd, &st) != 0,
+                           "vector file: stat failed");
+    MYSTL_RUNTIME_ERROR_IF(
+        static_cast<uint64_t>(st.st_size) < sizeof(vector_file_header),
+        "vector file: truncated");
+    const size_t file_size = static_cast<size_t>(st.st_size);
+    void *p = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file.fd, 0);
+    MYSTL_RUNTIME_ERROR_IF(p == MAP_FAILED, "vector file: mmap failed");
+    base = p;
+    length = file_size;
+    attach();
+}
+#endif
+
+// 映射建立后校验文件头并定位数据区，失败时释放映射
+template <typename T>
+void mapped_vector<T>::attach() {
+    const vector_file_header *h = static_cast<const vector_file_header *>(base);
+    try {
+        h->check<T>();
+        MYSTL_RUNTIME_ERROR_IF(
+            h->count > (length - sizeof(vector_file_header)) / sizeof(T),
+            "vector file: truncated");
+    } catch (...) {
+        unmap();
+        throw;
+    }
+    first = reinterpret_cast<const T *>(static_cast<const char *>(base) +
+                                        sizeof(vector_file_header));
+    count = static_cast<size_type>(h->count);
+}
+
+template <typename T>
+void mapped_vector<T>::unmap() {
+    if (base == nullptr) return;
+#if defined(_WIN32)
+    ::UnmapViewOfFile(base);
+    ::CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    ::munmap(base, length);
+#endif
+    base = nullptr;
+    length = 0;
+    first = nullptr;
+    count = 0;
+}
+}  // namespace mystl
@@ -0,0 +1,165 @@
+#pragma once
+
+// Chase-Lev工作窃取双端队列(按Lê等人给出的C11内存序实现)
+// 所有者线程在bottom一端push/pop，其他线程在top一端steal，均不加锁。
+// 底层是容量为2的幂的环形数组，满时所有者把内容拷到两倍大的新数组。
+// 窃取者可能仍在读旧数组，所以旧数组不立即释放，挂到retired链表上，
+// 析构时统一释放；数组容量每次翻倍，旧数组总大小不超过当前数组。
+// 窃取者可能读到随后被别人取走的槽位，再由CAS判定是否有效，
+// 因此元素必须是平凡可拷贝的，通常存放任务指针或下标。
+// steal在与其他线程竞争失败时也会返回false，调用方可以换一个队列重试。
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "allocator.h"
+#include "util.h"
+
+namespace mystl {
+template <typename T>
+class work_stealing_deque {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "work_stealing_deque requires a trivially copyable type");
+
+   public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+   protected:
+    struct ring {
+        difference_type capacity;
+        difference_type mask;
+        std::atomic<T> *slots;
+        ring *retired;  // 更早被替换下来的数组
+
+        T get(difference_type i) const {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+        void put(difference_type i, T value) {
+            slots[i & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+    using ring_alloc = mystl::allocator<ring>;
+    using slot_alloc = mystl::allocator<std::atomic<T>>;
+
+    // 所有者和窃取者都写top，只有所有者写bottom
+    alignas(cache_line_size) std::atomic<difference_type> top;
+    alignas(cache_line_size) std::atomic<difference_type> bottom;
+    std::atomic<ring *> array;
+
+    static ring *make_ring(difference_type capacity, ring *retired) {
+        ring *r = ::new (static_cast<void *>(ring_alloc::allocate(1))) ring;
+        try {
+            r->slots = slot_alloc::allocate(capacity);
+        } catch (...) {
+            ring_alloc::deallocate(r, 1);
+            throw;
+        }
+        for (difference_type i = 0; i < capacity; ++i) {
+            ::new (static_cast<void *>(r->slots + i)) std::atomic<T>();
+        }
+        r->capacity = capacity;
+        r->mask = capacity - 1;
+        r->retired = retired;
+        return r;
+    }
+
+    // 所有者调用：把[t, b)搬到两倍大的新数组
+    ring *grow(ring *old, difference_type b, difference_type t) {
+        ring *r = make_ring(old->capacity * 2, old);
+        for (difference_type i = t; i < b; ++i) {
+            r->put(i, old->get(i));
+        }
+        array.store(r, std::memory_order_release);
+        return r;
+    }
+
+   public:
+    // 构造函数，capacity向上取到2的幂
+    explicit work_stealing_deque(size_type capacity = 256) : top(0), bottom(0) {
+        difference_type cap = 2;
+        while (cap < static_cast<difference_type>(capacity)) cap <<= 1;
+        array.store(make_ring(cap, nullptr), std::memory_order_relaxed);
+    }
+    work_stealing_deque(const work_stealing_deque &) = delete;
+    work_stealing_deque &operator=(const work_stealing_deque &) = delete;
+
+    // 析构函数，不能与其他操作并发
+    ~work_stealing_deque() {
+        ring *r = array.load(std::memory_order_relaxed);
+        while (r != nullptr) {
+            ring *next = r->retired;
+            slot_alloc::deallocate(r->slots, r->capacity);
+            ring_alloc::deallocate(r, 1);
+            r = next;
+        }
+    }
+
+    // 并发时只是某一时刻的近似值
+    size_type size() const {
+        const difference_type b = bottom.load(std::memory_order_relaxed);
+        const difference_type t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_type>(b - t) : 0;
+    }
+    bool empty() const { return size() == 0; }
+    size_type capacity() const {
+        return array.load(std::memory_order_relaxed)->capacity;
+    }
+
+    // 所有者：压入bottom一端
+    void push(T value) {
+        const difference_type b = bottom.load(std::memory_order_relaxed);
+        const difference_type t = top.load(std::memory_order_acquire);
+        ring *a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // 所有者：从bottom一端弹出，队列空时返回false
+    bool pop(T &value) {
+        const difference_type b = bottom.load(std::memory_order_relaxed) - 1;
+        ring *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        difference_type t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        const T tmp = a->get(b);
+        if (t == b) {
+            // 只剩最后一个元素，和窃取者竞争
+            const bool won = top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst,
+                std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won) return false;
+        }
+        value = tmp;
+        return true;
+    }
+
+    // 任意线程：从top一端窃取，队列空或竞争失败时返回false
+    bool steal(T &value) {
+        difference_type t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const difference_type b = bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        ring *a = array.load(std::memory_order_acquire);
+        const T tmp = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return false;
+        }
+        value = tmp;
+        return true;
+    }
+};
+}  // namespace mystl